@@ -1,7 +1,7 @@
 // VMSconnection_manager.c
 
 #include "VMSconnection_manager.h"
-#include "minIni.h"
+#include "ini_index.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,11 +14,21 @@
 #include <arpa/inet.h>
 #include <unistd.h> // for close(), usleep()
 #include <errno.h>  // for errno, strerror()
-#include <sys/time.h> // for struct timeval (select timeout)
 #include <pthread.h> // pthread_mutex_lock/unlock 사용
-
-#define MAX_INI_LINE_LENGTH 256
-#define CONNECTION_RETRY_DELAY_MS 500 // 0.5s
+#include <time.h>     // clock_gettime (연결 시도 제한 시간)
+#include <sys/epoll.h> // 논블로킹 connect 완료 및 연결 끊김 감지
+#include <stddef.h>   // offsetof
+#include "timer_wheel.h"
+
+#define CONNECTION_RETRY_DELAY_MS 500 // 0.5s, 첫 재연결 대기 기본값
+#define CONNECTION_RETRY_MAX_DELAY_MS 30000 // 재연결 대기 상한 기본값
+#define CONNECTION_RETRY_MULTIPLIER 2.0
+#define CONNECTION_RETRY_JITTER_PERCENT 50
+#define CONNECT_POLL_SLICE_MS 100 // 종료 플래그 확인 주기
+#define CONNECT_MAX_EVENTS 64
+#define CONNECT_TIMER_TICK_MS 10  // 타이머 휠 해상도
+#define CONNECT_TIMER_SLOTS 512   // 타이머 휠 한 바퀴 = 5.12초
+#define RELOAD_SETTLE_DEFAULT_MS 200 // vms_servers.ini 변경 후 다시 읽기까지 기다리는 시간 기본값
 
 // Helper function to convert IP string to uint32_t (network byte order)
 static int ip_str_to_uint32(const char* ip_str, uint32_t* out_ip_int) {
@@ -40,79 +50,491 @@ static int uint32_to_ip_str(uint32_t ip_int, char* out_ip_str, size_t str_len) {
     return -1;
 }
 
-// select()를 사용하여 소켓이 여전히 유효한지 확인하는 함수
-static int is_socket_alive_with_select(int sockfd) {
-    if (sockfd < 0) {
-        return 0;
+static long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// 연결 관리 스레드 전용 상태
+typedef struct {
+    VMSServers* servers;
+    int epoll_fd;          // 진행 중인 connect의 완료, 연결된 소켓의 끊김, vms_servers.ini 변경
+    TimerWheel wheel;      // 서버별 재연결 대기와 연결 시도 제한 시간, 구성 다시 읽기 대기
+    unsigned int rand_seed; // 재연결 지터용
+    FileWatch ini_watch;   // vms_servers.ini 변경 감지 (핫 리로드가 꺼져 있으면 fd는 -1)
+    TimerWheelNode reload_timer; // 마지막 변경 후 reload_settle_ms가 지나면 다시 읽는다
+    bool reload_pending;   // reload_timer가 만료됨. 타이머 처리가 끝난 뒤 다시 읽는다
+} ConnectionEngine;
+
+static VMSServerInfo* server_of_timer(TimerWheelNode* node) {
+    return (VMSServerInfo*)((char*)node - offsetof(VMSServerInfo, timer));
+}
+
+// 연속 실패 횟수에 따라 다음 연결 시도를 예약한다 (지수 증가, 상한, 지터)
+static void schedule_retry(ConnectionEngine* eng, VMSServerInfo* server) {
+    const VMSRetryPolicy* policy = &server->retry;
+    server->connect_attempts++;
+
+    double delay = policy->initial_delay_ms;
+    for (int i = 1; i < server->connect_attempts && delay < policy->max_delay_ms; ++i) delay *= policy->multiplier;
+    if (delay > policy->max_delay_ms) delay = policy->max_delay_ms;
+    // 같은 시각에 끊긴 서버들이 한꺼번에 재연결하지 않도록 대기 시간을 무작위로 줄인다
+    double r = rand_r(&eng->rand_seed) / ((double)RAND_MAX + 1.0);
+    delay -= delay * policy->jitter_percent / 100.0 * r;
+    if (delay < CONNECT_TIMER_TICK_MS) delay = CONNECT_TIMER_TICK_MS;
+
+    server->next_attempt_ms = monotonic_ms() + (long long)delay;
+    timer_wheel_schedule(&eng->wheel, &server->timer, server->next_attempt_ms);
+    printf("[ManagerThread] 재연결 대기: %d번 그룹, %s:%d (%d ms 후, %d번째 재시도)\n",
+           server->group_id_for_log, server->ip_address, server->port, (int)delay, server->connect_attempts);
+}
+
+// 연결에 성공한 소켓을 서버에 등록하고 송신 큐에 붙인다.
+// 이후 이 소켓은 끊김(EPOLLRDHUP/EPOLLHUP/EPOLLERR)만 감시한다. registered면 이미 epoll에 있는 소켓 (connect 진행 중 등록)
+static void install_connected_socket(ConnectionEngine* eng, VMSServerInfo* server, int new_sock, bool registered) {
+    VMSServers* vms_servers = eng->servers;
+    printf("[ManagerThread] 연결 성공: %d번 그룹, %s:%d (새 핸들: %d)\n",
+           server->group_id_for_log, server->ip_address, server->port, new_sock);
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLRDHUP; // EPOLLHUP, EPOLLERR는 항상 보고됨
+    ev.data.ptr = server;
+    if (epoll_ctl(eng->epoll_fd, registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, new_sock, &ev) < 0) {
+        fprintf(stderr, "[ManagerThread] epoll 등록 실패 (그룹 %d, %s:%d): %s\n",
+                server->group_id_for_log, server->ip_address, server->port, strerror(errno));
+        close(new_sock);
+        schedule_retry(eng, server);
+        return;
     }
-    fd_set read_fds;
-    fd_set err_fds;
-    struct timeval tv;
-    int retval;
+    server->connect_attempts = 0;
+    timer_wheel_cancel(&eng->wheel, &server->timer);
+
+    // 전송 경로는 서버별 송신 큐 잠금만 사용하므로 다른 그룹의 전송과 경합하지 않는다
+    int old_sock = atomic_load(&server->socket_handle);
+    // 만약 이전 핸들이 아직 남아있다면 닫아준다.
+    if(old_sock != -1 && old_sock != new_sock) {
+        if (vms_servers->sender) vms_send_queue_detach(&server->send_queue);
+        close(old_sock);
+    }
+    atomic_store(&server->socket_handle, new_sock);
+    if (vms_servers->sender) vms_send_queue_attach(&server->send_queue, new_sock);
+}
 
-    FD_ZERO(&read_fds);
-    FD_ZERO(&err_fds);
-    FD_SET(sockfd, &read_fds);
-    FD_SET(sockfd, &err_fds);
+// 진행 중인 연결 시도를 취소한다
+static void abort_pending_connect(ConnectionEngine* eng, VMSServerInfo* server) {
+    if (server->connecting_fd == -1) return;
+    epoll_ctl(eng->epoll_fd, EPOLL_CTL_DEL, server->connecting_fd, NULL);
+    close(server->connecting_fd);
+    server->connecting_fd = -1;
+}
 
-    tv.tv_sec = 0;
-    tv.tv_usec = 0; // Non-blocking check
+// 논블로킹 connect를 시작한다. 바로 끝나지 않으면 epoll에 등록하고 제한 시간 타이머를 건 뒤 반환 (블로킹 없음)
+static void start_connect(ConnectionEngine* eng, VMSServerInfo* server) {
+    printf("[ManagerThread] 연결 시도: %d번 그룹, %s:%d\n",
+           server->group_id_for_log, server->ip_address, server->port);
 
-    retval = select(sockfd + 1, &read_fds, NULL, &err_fds, &tv);
+    int new_sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (new_sock < 0) {
+        fprintf(stderr, "[ManagerThread] 소켓 생성 실패 (그룹 %d, %s:%d): %s\n",
+                server->group_id_for_log, server->ip_address, server->port, strerror(errno));
+        schedule_retry(eng, server);
+        return;
+    }
 
-    if (retval == -1) {
-        perror("select() in is_socket_alive_with_select");
-        return 0;
+    struct sockaddr_in serv_addr;
+    memset(&serv_addr, 0, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(server->port);
+
+    if (inet_pton(AF_INET, server->ip_address, &serv_addr.sin_addr) <= 0) {
+        fprintf(stderr, "[ManagerThread] 잘못된 주소 (그룹 %d): %s\n",
+                server->group_id_for_log, server->ip_address);
+        close(new_sock);
+        schedule_retry(eng, server);
+        return;
     }
 
-    if (FD_ISSET(sockfd, &err_fds)) {
-        int error_code = 0;
-        socklen_t error_code_len = sizeof(error_code);
-        if (getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &error_code, &error_code_len) == 0) {
-            if (error_code != 0) {
-                return 0;
-            }
+    if (connect(new_sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) == 0) {
+        install_connected_socket(eng, server, new_sock, false); // 로컬 주소 등은 바로 연결될 수 있음
+        return;
+    }
+    if (errno != EINPROGRESS) {
+        fprintf(stderr, "[ManagerThread] 연결 실패: %d번 그룹, %s:%d (에러: %s)\n",
+            server->group_id_for_log, server->ip_address, server->port, strerror(errno));
+        close(new_sock);
+        schedule_retry(eng, server);
+        return;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLOUT;
+    ev.data.ptr = server;
+    if (epoll_ctl(eng->epoll_fd, EPOLL_CTL_ADD, new_sock, &ev) < 0) {
+        fprintf(stderr, "[ManagerThread] epoll 등록 실패 (그룹 %d, %s:%d): %s\n",
+                server->group_id_for_log, server->ip_address, server->port, strerror(errno));
+        close(new_sock);
+        schedule_retry(eng, server);
+        return;
+    }
+    server->connecting_fd = new_sock;
+    timer_wheel_schedule(&eng->wheel, &server->timer, monotonic_ms() + eng->servers->connect_timeout_ms);
+}
+
+// 연결된 소켓의 끊김을 처리한다. 송신 큐에서 먼저 떼어낸 뒤 닫는다 (송신 스레드가 닫힌 핸들에 쓰지 않도록).
+static void drop_connection(ConnectionEngine* eng, VMSServerInfo* server) {
+    VMSServers* vms_servers = eng->servers;
+    int fd = atomic_load(&server->socket_handle);
+    if (fd == -1) return;
+    fprintf(stderr, "[ManagerThread] 연결 유실/오류 감지: 그룹 %d, %s:%d (핸들: %d). 이전 소켓 닫음.\n",
+           server->group_id_for_log, server->ip_address, server->port, fd);
+    epoll_ctl(eng->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+
+    if (vms_servers->sender) vms_send_queue_detach(&server->send_queue); // 서버별 송신 큐 잠금 안에서 떼어냄
+    atomic_store(&server->socket_handle, -1);   // 핸들 무효화
+    close(fd);
+
+    server->connect_attempts = 0; // 끊긴 직후에는 첫 재시도 간격부터 다시 시작
+    schedule_retry(eng, server);
+}
+
+// 쓰기 가능 이벤트가 온 연결 시도의 결과를 확인한다
+static void finish_connect(ConnectionEngine* eng, VMSServerInfo* server) {
+    int fd = server->connecting_fd;
+    server->connecting_fd = -1;
+    timer_wheel_cancel(&eng->wheel, &server->timer);
+
+    int error_code = 0;
+    socklen_t error_code_len = sizeof(error_code);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error_code, &error_code_len) < 0) error_code = errno;
+    if (error_code != 0) {
+        fprintf(stderr, "[ManagerThread] 연결 실패: %d번 그룹, %s:%d (에러: %s)\n",
+            server->group_id_for_log, server->ip_address, server->port, strerror(error_code));
+        epoll_ctl(eng->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        close(fd);
+        schedule_retry(eng, server);
+        return;
+    }
+    install_connected_socket(eng, server, fd, true);
+}
+
+static void reload_topology(ConnectionEngine* eng);
+static void drain_ini_events(ConnectionEngine* eng);
+
+// 서버 타이머 만료: 연결 시도 중이면 제한 시간 초과, 대기 중이면 재연결 시도
+static void on_server_timer(TimerWheelNode* node, void* user_data) {
+    ConnectionEngine* eng = (ConnectionEngine*)user_data;
+    if (node == &eng->reload_timer) {
+        // 다시 읽기는 다른 서버의 타이머를 빼고 거므로 콜백 밖(timer_wheel_advance 이후)에서 한다
+        eng->reload_pending = true;
+        return;
+    }
+    VMSServerInfo* server = server_of_timer(node);
+    if (server->connecting_fd != -1) {
+        fprintf(stderr, "[ManagerThread] 연결 실패: %d번 그룹, %s:%d (에러: %d ms 내 응답 없음)\n",
+            server->group_id_for_log, server->ip_address, server->port, eng->servers->connect_timeout_ms);
+        abort_pending_connect(eng, server);
+        schedule_retry(eng, server);
+    } else if (atomic_load(&server->socket_handle) == -1) {
+        start_connect(eng, server);
+    }
+}
+
+// 최대 wait_ms 동안 소켓 이벤트를 처리한다: 진행 중인 연결 시도의 완료, 연결된 소켓의 끊김, vms_servers.ini 변경
+static void poll_connection_events(ConnectionEngine* eng, int wait_ms) {
+    struct epoll_event events[CONNECT_MAX_EVENTS];
+    int n = epoll_wait(eng->epoll_fd, events, CONNECT_MAX_EVENTS, wait_ms);
+    for (int i = 0; i < n; ++i) {
+        if (events[i].data.ptr == eng) {
+            drain_ini_events(eng);
+            continue;
+        }
+        VMSServerInfo* server = (VMSServerInfo*)events[i].data.ptr;
+        if (server->connecting_fd != -1) {
+            finish_connect(eng, server);
         } else {
-            perror("getsockopt in is_socket_alive_with_select");
-            return 0;
+            drop_connection(eng, server); // EPOLLRDHUP, EPOLLHUP, EPOLLERR
         }
     }
+}
 
-    if (FD_ISSET(sockfd, &read_fds)) {
-        char buffer[1];
-        ssize_t n = recv(sockfd, buffer, sizeof(buffer), MSG_PEEK | MSG_DONTWAIT);
-        if (n == 0) { // Peer closed connection
-            return 0;
-        } else if (n < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                return 1; // Still alive, just no data
-            }
-            return 0; // Other recv error
+static size_t group_hash(int group_id, size_t mask) {
+    uint32_t h = (uint32_t)group_id * 0x9E3779B1u;
+    return (size_t)(h ^ (h >> 16)) & mask;
+}
+
+// 그룹 ID -> groups 배열 인덱스 해시 테이블 (개방 주소법). 그룹 배열이 확정된 뒤 한 번 만든다.
+// 같은 ID의 그룹이 여럿이면 선형 탐색과 같게 먼저 나온 그룹을 사용한다.
+static bool build_group_index(VMSTopology* topology) {
+    size_t size = 16;
+    while (size < (size_t)topology->num_groups * 2) size <<= 1;
+    topology->group_index = (int*)malloc(size * sizeof(int));
+    if (!topology->group_index) {
+        perror("[VMSManager] Failed to allocate group index");
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i) topology->group_index[i] = -1;
+    topology->group_index_mask = size - 1;
+
+    for (int g = 0; g < topology->num_groups; ++g) {
+        int id = topology->groups[g].group_id;
+        size_t slot = group_hash(id, topology->group_index_mask);
+        while (topology->group_index[slot] != -1 && topology->groups[topology->group_index[slot]].group_id != id) {
+            slot = (slot + 1) & topology->group_index_mask;
         }
-        return 1; // Data peeked, so alive
+        if (topology->group_index[slot] != -1) {
+            fprintf(stderr, "[VMSManager] Warning: Duplicate group ID %d. Messages go to the first section only.\n", id);
+            continue;
+        }
+        topology->group_index[slot] = g;
     }
-    return 1; // select timed out (0), no error/read event implies alive for now
+    return true;
 }
 
-VMSServers* vms_manager_init(const char* ini_filepath) {
-    VMSServers* vms_data = (VMSServers*)calloc(1, sizeof(VMSServers));
-    if (!vms_data) {
-        perror("Failed to allocate VMSServers");
-        return NULL;
+const VMSServerGroup* vms_manager_find_group(const VMSTopology* topology, int group_id) {
+    if (!topology || !topology->group_index) return NULL;
+    size_t slot = group_hash(group_id, topology->group_index_mask);
+    int g;
+    while ((g = topology->group_index[slot]) != -1) {
+        if (topology->groups[g].group_id == group_id) return &topology->groups[g];
+        slot = (slot + 1) & topology->group_index_mask;
     }
+    return NULL;
+}
 
-    if (pthread_mutex_init(&vms_data->mutex, NULL) != 0) {
-        perror("Failed to initialize mutex for VMSServers");
-        free(vms_data);
-        return NULL;
+// 구성 배열만 해제한다 (서버 객체는 구성끼리 공유하므로 따로 해제)
+static void free_topology(VMSTopology* topology) {
+    if (!topology) return;
+    for (int i = 0; i < topology->num_groups; ++i) free(topology->groups[i].server_ids);
+    free(topology->groups);
+    free(topology->servers);
+    free(topology->group_index);
+    free(topology);
+}
+
+static void free_topology_node(HazardNode* node) {
+    free_topology(vms_topology_of_node(node));
+}
+
+// (IP, PORT) -> servers 인덱스 해시 테이블 (로드 중에만 사용)
+typedef struct {
+    uint32_t ip_host_order;
+    int port;
+    int server_id;  // 빈 칸은 -1
+} ServerTableEntry;
+
+typedef struct {
+    ServerTableEntry* slots;
+    size_t mask;
+    size_t count;
+} ServerTable;
+
+static size_t server_hash(uint32_t ip_host_order, int port, size_t mask) {
+    uint32_t h = (ip_host_order ^ ((uint32_t)port * 0x85EBCA6Bu)) * 0x9E3779B1u;
+    return (size_t)(h ^ (h >> 16)) & mask;
+}
+
+// 키가 같은 칸이나 빈 칸을 찾는다
+static ServerTableEntry* server_table_probe(ServerTable* table, uint32_t ip_host_order, int port) {
+    size_t slot = server_hash(ip_host_order, port, table->mask);
+    while (table->slots[slot].server_id != -1 &&
+           (table->slots[slot].ip_host_order != ip_host_order || table->slots[slot].port != port)) {
+        slot = (slot + 1) & table->mask;
+    }
+    return &table->slots[slot];
+}
+
+// 해시 테이블을 부하율 1/2 이하로 유지 (커지면 두 배로 다시 만든다)
+static bool server_table_reserve(ServerTable* table, size_t count) {
+    size_t size = table->slots ? table->mask + 1 : 0;
+    if (count * 2 <= size) return true;
+    size_t new_size = size ? size : 64;
+    while (count * 2 > new_size) new_size <<= 1;
+
+    ServerTable grown = { (ServerTableEntry*)malloc(new_size * sizeof(ServerTableEntry)), new_size - 1, table->count };
+    if (!grown.slots) {
+        perror("[VMSManager] Failed to allocate server table");
+        return false;
+    }
+    for (size_t i = 0; i < new_size; ++i) grown.slots[i].server_id = -1;
+    for (size_t i = 0; i < size; ++i) {
+        if (table->slots[i].server_id != -1) {
+            *server_table_probe(&grown, table->slots[i].ip_host_order, table->slots[i].port) = table->slots[i];
+        }
+    }
+    free(table->slots);
+    *table = grown;
+    return true;
+}
+
+// 키를 추가한다 (이미 있으면 그대로)
+static bool server_table_insert(ServerTable* table, uint32_t ip_host_order, int port, int server_id) {
+    if (!server_table_reserve(table, table->count + 1)) return false;
+    ServerTableEntry* entry = server_table_probe(table, ip_host_order, port);
+    if (entry->server_id != -1) return true;
+    entry->ip_host_order = ip_host_order;
+    entry->port = port;
+    entry->server_id = server_id;
+    table->count++;
+    return true;
+}
+
+// 없으면 -1
+static int server_table_find(ServerTable* table, uint32_t ip_host_order, int port) {
+    if (!table->slots) return -1;
+    return server_table_probe(table, ip_host_order, port)->server_id;
+}
+
+static uint32_t server_ip_host_order(const VMSServerInfo* server) {
+    uint32_t ip = 0;
+    ip_str_to_uint32(server->ip_address, &ip);
+    return ntohl(ip);
+}
+
+// vms_servers.ini 한 번을 읽는 동안의 상태
+// 새 구성의 서버는 현재 구성(live)이나 parked에 같은 IP:PORT가 있으면 그 객체를 그대로 쓰고, 없을 때만 새로 만든다.
+typedef struct {
+    VMSServers* vms;
+    const VMSTopology* live;    // 현재 구성 (처음 읽을 때는 NULL)
+    ServerTable live_table;     // live 서버 (IP, PORT) -> live->servers 인덱스
+    ServerTable table;          // 새 구성 서버 (IP, PORT) -> topology->servers 인덱스
+    VMSTopology* topology;      // 만드는 중인 구성
+    int servers_capacity;
+    VMSServerInfo** fresh;      // 이번에 새로 만든 서버 (실패하면 해제)
+    int num_fresh;
+    int fresh_capacity;
+    int num_revived;            // parked에서 다시 꺼낸 서버 수
+} TopologyBuilder;
+
+static bool append_pointer(VMSServerInfo*** array, int* count, int* capacity, VMSServerInfo* server) {
+    if (*count == *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 16;
+        VMSServerInfo** grown = (VMSServerInfo**)realloc(*array, (size_t)new_capacity * sizeof(VMSServerInfo*));
+        if (!grown) {
+            perror("[VMSManager] Failed to realloc servers array");
+            return false;
+        }
+        *array = grown;
+        *capacity = new_capacity;
     }
+    (*array)[(*count)++] = server;
+    return true;
+}
+
+static VMSServerInfo* find_parked(const VMSServers* vms_data, const char* ip_address, int port) {
+    for (int i = 0; i < vms_data->num_parked; ++i) {
+        VMSServerInfo* server = vms_data->parked[i];
+        if (server->port == port && strcmp(server->ip_address, ip_address) == 0) return server;
+    }
+    return NULL;
+}
+
+// 같은 IP:PORT 서버가 이미 있으면 그 인덱스를, 없으면 새로 추가한 인덱스를 반환. 실패 시 -1
+static int find_or_add_server(TopologyBuilder* b, uint32_t ip_host_order, int port, const VMSServerGroup* group) {
+    VMSTopology* topology = b->topology;
+    int id = server_table_find(&b->table, ip_host_order, port);
+    if (id != -1) {
+        topology->servers[id]->num_member_groups++;
+        return id;
+    }
+
+    char ip_address[16];
+    uint32_to_ip_str(htonl(ip_host_order), ip_address, sizeof(ip_address));
+
+    VMSServerInfo* server = NULL;
+    int live_id = server_table_find(&b->live_table, ip_host_order, port);
+    if (live_id != -1) {
+        server = b->live->servers[live_id]; // 두 구성에 모두 있는 서버: 소켓과 송신 큐를 그대로 유지
+    } else if ((server = find_parked(b->vms, ip_address, port)) != NULL) {
+        b->num_revived++;
+    } else {
+        server = (VMSServerInfo*)calloc(1, sizeof(VMSServerInfo));
+        if (!server) {
+            perror("[VMSManager] Failed to allocate VMSServerInfo");
+            return -1;
+        }
+        snprintf(server->ip_address, sizeof(server->ip_address), "%s", ip_address);
+        server->port = port;
+        atomic_init(&server->socket_handle, -1);
+        server->connecting_fd = -1;
+        server->group_id_for_log = group->group_id;
+        if (!append_pointer(&b->fresh, &b->num_fresh, &b->fresh_capacity, server)) {
+            free(server);
+            return -1;
+        }
+    }
+    server->retry = group->retry;
+    server->num_member_groups = 1;
+
+    id = topology->num_servers;
+    if (!append_pointer(&topology->servers, &topology->num_servers, &b->servers_capacity, server) ||
+        !server_table_insert(&b->table, ip_host_order, port, id)) {
+        return -1;
+    }
+    return id;
+}
 
-    char section_name_buffer[MAX_INI_LINE_LENGTH];
-    int section_idx = 0;
+// 그룹 섹션에서 재연결 정책을 읽는다. 없거나 잘못된 값은 기본값으로 보정
+static void load_retry_policy(const IniIndex* ini, const char* section, VMSRetryPolicy* policy) {
+    policy->initial_delay_ms = (int)ini_index_getl(ini, section, "재연결 최소 간격(ms)", CONNECTION_RETRY_DELAY_MS);
+    policy->max_delay_ms = (int)ini_index_getl(ini, section, "재연결 최대 간격(ms)", CONNECTION_RETRY_MAX_DELAY_MS);
+    policy->multiplier = ini_index_getf(ini, section, "재연결 배수", CONNECTION_RETRY_MULTIPLIER);
+    policy->jitter_percent = (int)ini_index_getl(ini, section, "재연결 지터(%)", CONNECTION_RETRY_JITTER_PERCENT);
+
+    if (policy->initial_delay_ms <= 0) policy->initial_delay_ms = CONNECTION_RETRY_DELAY_MS;
+    if (policy->max_delay_ms < policy->initial_delay_ms) policy->max_delay_ms = policy->initial_delay_ms;
+    if (policy->multiplier < 1.0) policy->multiplier = 1.0;
+    if (policy->jitter_percent < 0) policy->jitter_percent = 0;
+    if (policy->jitter_percent > 100) policy->jitter_percent = 100;
+}
+
+// 실패한 로드를 되돌린다: 새로 만든 서버와 구성 배열만 해제 (live와 parked 서버는 그대로)
+static void discard_builder(TopologyBuilder* b) {
+    for (int i = 0; i < b->num_fresh; ++i) free(b->fresh[i]);
+    free(b->fresh);
+    free(b->table.slots);
+    free(b->live_table.slots);
+    free_topology(b->topology);
+    memset(b, 0, sizeof(*b));
+}
+
+// vms_servers.ini를 읽어 새 구성을 만든다. 성공하면 b->topology에 결과가 있고 true를 반환
+static bool load_topology(TopologyBuilder* b, VMSServers* vms_data, const VMSTopology* live) {
+    const char* ini_filepath = vms_data->ini_filepath;
+    memset(b, 0, sizeof(*b));
+    b->vms = vms_data;
+    b->live = live;
+    b->topology = (VMSTopology*)calloc(1, sizeof(VMSTopology));
+    if (!b->topology) {
+        perror("Failed to allocate VMSTopology");
+        return false;
+    }
+    b->topology->version = live ? live->version + 1 : 1;
+    if (live) {
+        for (int i = 0; i < live->num_servers; ++i) {
+            if (!server_table_insert(&b->live_table, server_ip_host_order(live->servers[i]), live->servers[i]->port, i)) {
+                discard_builder(b);
+                return false;
+            }
+        }
+    }
 
     printf("[VMSManager] Loading server config from: %s\n", ini_filepath);
 
-    while (ini_getsection(section_idx++, section_name_buffer, sizeof(section_name_buffer), ini_filepath) > 0) {
+    // 파일을 한 번만 읽어 색인한다 (섹션마다 키를 ini_gets로 읽으면 섹션 수의 제곱만큼 파일을 훑게 된다)
+    IniIndex* ini = ini_index_load(ini_filepath);
+    if (!ini && live) {
+        // 잠깐 없거나 읽을 수 없는 파일을 빈 구성으로 게시하면 모든 서버 연결을 닫게 되므로 현재 구성을 유지한다
+        discard_builder(b);
+        return false;
+    }
+    int num_sections = ini_index_num_sections(ini);
+    VMSTopology* topology = b->topology;
+
+    for (int section_idx = 0; section_idx < num_sections; ++section_idx) {
+        const char* section_name_buffer = ini_index_section_name(ini, section_idx);
         int current_group_id = -1;
         // 섹션 이름에서 그룹 ID 파싱 (예: "1번 그룹" -> 1)
         if (sscanf(section_name_buffer, "%d번 그룹", &current_group_id) == 1 ||
@@ -129,9 +551,9 @@ VMSServers* vms_manager_init(const char* ini_filepath) {
         int port = 0;
 
         // 현재 섹션(current_group_id에 해당하는)에서 키 값들 읽기
-        ini_gets(section_name_buffer, "시작 IP", "", start_ip_str, sizeof(start_ip_str), ini_filepath);
-        ini_gets(section_name_buffer, "끝 IP", "", end_ip_str, sizeof(end_ip_str), ini_filepath);
-        ini_gets(section_name_buffer, "PORT", "0", port_str, sizeof(port_str), ini_filepath);
+        ini_index_gets(ini, section_name_buffer, "시작 IP", "", start_ip_str, sizeof(start_ip_str));
+        ini_index_gets(ini, section_name_buffer, "끝 IP", "", end_ip_str, sizeof(end_ip_str));
+        ini_index_gets(ini, section_name_buffer, "PORT", "0", port_str, sizeof(port_str));
         port = atoi(port_str);
 
         if (start_ip_str[0] == '\0' || end_ip_str[0] == '\0' || port == 0) {
@@ -140,17 +562,20 @@ VMSServers* vms_manager_init(const char* ini_filepath) {
         }
 
         // 그룹 정보 추가 로직 (realloc 등)
-        vms_data->num_groups++;
-        VMSServerGroup* new_groups_ptr = (VMSServerGroup*)realloc(vms_data->groups, vms_data->num_groups * sizeof(VMSServerGroup));
+        topology->num_groups++;
+        VMSServerGroup* new_groups_ptr = (VMSServerGroup*)realloc(topology->groups, topology->num_groups * sizeof(VMSServerGroup));
         if (!new_groups_ptr) {
             perror("[VMSManager] Failed to realloc groups array");
-            vms_manager_cleanup(vms_data);
-            return NULL;
+            topology->num_groups--;
+            ini_index_free(ini);
+            discard_builder(b);
+            return false;
         }
-        vms_data->groups = new_groups_ptr;
-        VMSServerGroup* current_group_ptr = &vms_data->groups[vms_data->num_groups - 1];
+        topology->groups = new_groups_ptr;
+        VMSServerGroup* current_group_ptr = &topology->groups[topology->num_groups - 1];
         memset(current_group_ptr, 0, sizeof(VMSServerGroup));
         current_group_ptr->group_id = current_group_id;
+        load_retry_policy(ini, section_name_buffer, &current_group_ptr->retry);
 
         // IP 범위 처리 및 서버 정보 채우기
         uint32_t start_ip_int, end_ip_int;
@@ -164,48 +589,235 @@ VMSServers* vms_manager_init(const char* ini_filepath) {
                 fprintf(stderr, "[VMSManager] Error in Group %d: End IP is less than Start IP.\n", current_group_id);
             } else {
                 current_group_ptr->num_servers = (end_ip_int - start_ip_int) + 1;
-                current_group_ptr->servers = (VMSServerInfo*)calloc(current_group_ptr->num_servers, sizeof(VMSServerInfo));
-                if (!current_group_ptr->servers) {
-                    perror("[VMSManager] Failed to allocate VMSServerInfo array");
-                    vms_manager_cleanup(vms_data);
-                    return NULL;
+                current_group_ptr->server_ids = (int*)calloc(current_group_ptr->num_servers, sizeof(int));
+                if (!current_group_ptr->server_ids) {
+                    perror("[VMSManager] Failed to allocate server index array");
+                    ini_index_free(ini);
+                    discard_builder(b);
+                    return false;
                 }
+                int shared = 0;
                 for (int i_s = 0; i_s < current_group_ptr->num_servers; ++i_s) {
                     uint32_t current_ip_host_order = start_ip_int + i_s;
-                    uint32_to_ip_str(htonl(current_ip_host_order), current_group_ptr->servers[i_s].ip_address, sizeof(current_group_ptr->servers[i_s].ip_address));
-                    current_group_ptr->servers[i_s].port = port;
-                    current_group_ptr->servers[i_s].socket_handle = -1;
-                    current_group_ptr->servers[i_s].group_id_for_log = current_group_id;
-                    // init 시에는 VMSServerInfo의 state 등 다른 필드도 초기화 필요
-                    // current_group_ptr->servers[i_s].state = VMS_STATE_DISCONNECTED; // 만약 state 필드가 있다면
-                    // current_group_ptr->servers[i_s].last_attempt_time = 0;
-                    vms_data->total_servers_configured++;
+                    int server_id = find_or_add_server(b, current_ip_host_order, port, current_group_ptr);
+                    if (server_id < 0) {
+                        ini_index_free(ini);
+                        discard_builder(b);
+                        return false;
+                    }
+                    if (topology->servers[server_id]->num_member_groups > 1) shared++;
+                    current_group_ptr->server_ids[i_s] = server_id;
+                    topology->total_servers_configured++;
+                }
+                printf("[VMSManager] Group %d (%s) configured with %d servers (IPs: %s-%s, Port: %d, retry %d-%d ms x%.1f, jitter %d%%)\n",
+                       current_group_id, section_name_buffer, current_group_ptr->num_servers, start_ip_str, end_ip_str, port,
+                       current_group_ptr->retry.initial_delay_ms, current_group_ptr->retry.max_delay_ms,
+                       current_group_ptr->retry.multiplier, current_group_ptr->retry.jitter_percent);
+                if (shared > 0) {
+                    printf("[VMSManager]   %d server(s) of group %d are already in another group and share its connection\n",
+                           shared, current_group_id);
                 }
-                printf("[VMSManager] Group %d (%s) configured with %d servers (IPs: %s-%s, Port: %d)\n",
-                       current_group_id, section_name_buffer, current_group_ptr->num_servers, start_ip_str, end_ip_str, port);
             }
         } else {
             fprintf(stderr, "[VMSManager] Error parsing IPs for Group %d: StartIP='%s', EndIP='%s'\n",
                     current_group_id, start_ip_str, end_ip_str);
         }
-    } // end while (ini_getsection)
+    } // end for (sections)
+
+    ini_index_free(ini);
 
-    if (vms_data->num_groups == 0) {
+    if (!build_group_index(topology)) {
+        discard_builder(b);
+        return false;
+    }
+
+    if (topology->num_groups == 0) {
         fprintf(stderr, "[VMSManager] No server groups found in %s.\n", ini_filepath);
         // 설정된 서버가 없는 것이 오류가 아니라면 이 부분은 경고로 처리하거나,
         // vms_manager_cleanup 후 NULL 반환 대신 비어있는 vms_data를 반환할 수도 있습니다.
         // 현재는 num_groups가 0이어도 vms_data를 반환합니다.
     }
-    
+    return true;
+}
+
+VMSServers* vms_manager_init(const char* ini_filepath) {
+    VMSServers* vms_data = (VMSServers*)calloc(1, sizeof(VMSServers));
+    if (!vms_data) {
+        perror("Failed to allocate VMSServers");
+        return NULL;
+    }
+
+    vms_data->connect_timeout_ms = VMS_CONNECT_TIMEOUT_DEFAULT_MS;
+    vms_data->reload_settle_ms = RELOAD_SETTLE_DEFAULT_MS;
+    snprintf(vms_data->ini_filepath, sizeof(vms_data->ini_filepath), "%s", ini_filepath);
+    if (pthread_mutex_init(&vms_data->mutex, NULL) != 0) {
+        perror("Failed to initialize mutex for VMSServers");
+        free(vms_data);
+        return NULL;
+    }
+
+    TopologyBuilder b;
+    if (!load_topology(&b, vms_data, NULL)) {
+        pthread_mutex_destroy(&vms_data->mutex);
+        free(vms_data);
+        return NULL;
+    }
+    free(b.fresh); // 처음에는 모든 서버가 새 서버. 구성이 소유한다
+    free(b.table.slots);
+    hazard_domain_init(&vms_data->topology, &b.topology->node);
     return vms_data;
 }
 
+VMSTopologyReader* vms_manager_register_reader(VMSServers* vms_servers) {
+    VMSTopologyReader* reader = hazard_register_reader(&vms_servers->topology);
+    if (!reader) fprintf(stderr, "[VMSManager] 구성을 읽는 스레드는 최대 %d개까지 등록할 수 있습니다.\n", HAZARD_MAX_READERS);
+    return reader;
+}
+
+const VMSTopology* vms_manager_enter(VMSServers* vms_servers, VMSTopologyReader* reader) {
+    return vms_topology_of_node(hazard_enter(&vms_servers->topology, reader));
+}
+
+void vms_manager_leave(VMSTopologyReader* reader) {
+    hazard_leave(reader);
+}
+
+// 읽는 스레드가 hazard에 걸어 두지 않은 교체된 구성을 해제한다 (mutex 잠금 상태에서 호출)
+static void reclaim_retired_locked(VMSServers* vms_servers) {
+    hazard_reclaim(&vms_servers->topology, free_topology_node);
+}
+
+// 송신 큐 라벨은 서버가 있는 동안 바뀌지 않는 IP:PORT만 쓴다 (소속 그룹은 보고할 때 현재 구성에서 구한다)
+static void format_queue_label(const VMSServerInfo* server, char* label, size_t label_size) {
+    snprintf(label, label_size, "%s:%d", server->ip_address, server->port);
+}
+
+// 설정에서 빠진 서버의 연결을 닫고 parked로 옮긴다. 이전 구성을 아직 읽는 스레드가 있을 수 있으므로 해제하지 않는다.
+static bool park_server(ConnectionEngine* eng, VMSServerInfo* server) {
+    VMSServers* vms_servers = eng->servers;
+    VMSServerInfo** grown = (VMSServerInfo**)realloc(vms_servers->parked, (size_t)(vms_servers->num_parked + 1) * sizeof(VMSServerInfo*));
+    if (!grown) {
+        perror("[VMSManager] Failed to realloc parked servers");
+        return false;
+    }
+    vms_servers->parked = grown;
+    vms_servers->parked[vms_servers->num_parked++] = server;
+
+    abort_pending_connect(eng, server);
+    timer_wheel_cancel(&eng->wheel, &server->timer);
+    int fd = atomic_load(&server->socket_handle);
+    if (fd != -1) {
+        epoll_ctl(eng->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        if (vms_servers->sender) vms_send_queue_detach(&server->send_queue);
+        atomic_store(&server->socket_handle, -1);
+        close(fd);
+    }
+    server->connect_attempts = 0;
+    printf("[ManagerThread] 서버 제거: %s:%d (연결 닫음)\n", server->ip_address, server->port);
+    return true;
+}
+
+static void unpark_server(VMSServers* vms_servers, VMSServerInfo* server) {
+    for (int i = 0; i < vms_servers->num_parked; ++i) {
+        if (vms_servers->parked[i] == server) {
+            vms_servers->parked[i] = vms_servers->parked[--vms_servers->num_parked];
+            return;
+        }
+    }
+}
+
+// vms_servers.ini를 다시 읽어 현재 구성과 비교한다.
+// 두 구성에 모두 있는 서버는 소켓, 송신 큐, 재연결 상태를 그대로 두고, 새 서버만 연결하고 빠진 서버만 닫는다.
+static void reload_topology(ConnectionEngine* eng) {
+    VMSServers* vms_servers = eng->servers;
+    VMSTopology* live = vms_manager_topology(vms_servers); // 구성은 이 스레드만 바꾸므로 잠금 없이 읽어도 된다
+
+    TopologyBuilder b;
+    if (!load_topology(&b, vms_servers, live)) {
+        fprintf(stderr, "[ManagerThread] %s 다시 읽기 실패. 현재 구성(버전 %lu)을 유지합니다.\n",
+                vms_servers->ini_filepath, live->version);
+        return;
+    }
+    VMSTopology* next = b.topology;
+
+    // 새 서버의 송신 큐는 게시 전에 만든다 (실패하면 아무것도 바꾸지 않는다)
+    if (vms_servers->sender) {
+        for (int i = 0; i < b.num_fresh; ++i) {
+            char label[VMS_SEND_QUEUE_LABEL_SIZE];
+            format_queue_label(b.fresh[i], label, sizeof(label));
+            if (!vms_send_queue_init(&b.fresh[i]->send_queue, vms_servers->sender, vms_servers->send_queue_depth,
+                                     vms_servers->send_latest_only, label)) {
+                for (int k = 0; k < i; ++k) vms_send_queue_destroy(&b.fresh[k]->send_queue);
+                discard_builder(&b);
+                fprintf(stderr, "[ManagerThread] 송신 큐 생성 실패. 현재 구성(버전 %lu)을 유지합니다.\n", live->version);
+                return;
+            }
+        }
+    }
+
+    pthread_mutex_lock(&vms_servers->mutex);
+    hazard_publish(&vms_servers->topology, &next->node);
+    pthread_mutex_unlock(&vms_servers->mutex);
+
+    // 빠진 서버: 연결을 닫고 parked로
+    int removed = 0;
+    for (int i = 0; i < live->num_servers; ++i) {
+        VMSServerInfo* server = live->servers[i];
+        if (server_table_find(&b.table, server_ip_host_order(server), server->port) != -1) continue;
+        if (park_server(eng, server)) removed++;
+    }
+    // 새 서버와 parked에서 돌아온 서버만 연결 (나머지는 기존 연결 유지)
+    int added = 0;
+    for (int i = 0; i < next->num_servers; ++i) {
+        VMSServerInfo* server = next->servers[i];
+        if (server_table_find(&b.live_table, server_ip_host_order(server), server->port) != -1) continue;
+        unpark_server(vms_servers, server);
+        start_connect(eng, server);
+        added++;
+    }
+
+    pthread_mutex_lock(&vms_servers->mutex);
+    reclaim_retired_locked(vms_servers);
+    pthread_mutex_unlock(&vms_servers->mutex);
+
+    printf("[ManagerThread] 서버 구성 버전 %lu 적용: 그룹 %d개, 서버 %d개 (추가 %d (재사용 %d), 제거 %d, 유지 %d)\n",
+           next->version, next->num_groups, next->num_servers, added, b.num_revived, removed, next->num_servers - added);
+
+    free(b.fresh); // 새 서버는 이제 구성이 소유한다
+    free(b.table.slots);
+    free(b.live_table.slots);
+}
+
+// vms_servers.ini가 있는 디렉터리를 감시한다 (편집기는 보통 새 파일을 쓰고 이름을 바꾼다)
+static void watch_ini_file(ConnectionEngine* eng) {
+    const char* path = eng->servers->ini_filepath;
+    if (!file_watch_open(&eng->ini_watch, &path, 1)) return;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = eng;
+    if (eng->ini_watch.watches[0] < 0 || epoll_ctl(eng->epoll_fd, EPOLL_CTL_ADD, eng->ini_watch.fd, &ev) < 0) {
+        fprintf(stderr, "[ManagerThread] %s 감시 실패\n", path);
+        file_watch_close(&eng->ini_watch);
+        return;
+    }
+    printf("[ManagerThread] Watching %s for changes.\n", eng->servers->ini_filepath);
+}
+
+// inotify 이벤트를 비우고, vms_servers.ini가 바뀌었으면 다시 읽기 타이머를 (다시) 건다
+static void drain_ini_events(ConnectionEngine* eng) {
+    if (file_watch_drain(&eng->ini_watch)) {
+        timer_wheel_schedule(&eng->wheel, &eng->reload_timer, monotonic_ms() + eng->servers->reload_settle_ms);
+    }
+}
+
 void vms_manager_manage_connections(VMSServers* vms_servers) {
     if (!vms_servers) { // num_groups == 0 인 경우도 아래에서 처리됨
         fprintf(stderr, "[ManagerThread] VMS Server data is not initialized.\n");
         return;
     }
-    if (vms_servers->num_groups == 0 ) {
+    VMSTopology* topology = vms_manager_topology(vms_servers);
+    if (topology->num_groups == 0 && !vms_servers->hot_reload) {
          fprintf(stderr, "[ManagerThread] No groups to manage.\n");
         // keep_running_manager가 false가 될 때까지 대기하거나, 바로 리턴할 수 있음.
         // 여기서는 주기적으로 체크하며 대기.
@@ -216,130 +828,161 @@ void vms_manager_manage_connections(VMSServers* vms_servers) {
     }
 
 
-    printf("[ManagerThread] Starting VMS connection management loop...\n");
+    ConnectionEngine eng;
+    memset(&eng, 0, sizeof(eng));
+    eng.servers = vms_servers;
+    eng.ini_watch.fd = -1;
+    eng.rand_seed = (unsigned int)monotonic_ms() ^ (unsigned int)getpid();
+    eng.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (eng.epoll_fd < 0) {
+        perror("[ManagerThread] epoll_create1");
+        return;
+    }
+    if (!timer_wheel_init(&eng.wheel, CONNECT_TIMER_SLOTS, CONNECT_TIMER_TICK_MS, monotonic_ms())) {
+        close(eng.epoll_fd);
+        return;
+    }
+    if (vms_servers->hot_reload) watch_ini_file(&eng);
 
-    while (keep_running_manager) {
-        for (int i = 0; i < vms_servers->num_groups && keep_running_manager; ++i) {
-            VMSServerGroup* group = &vms_servers->groups[i];
-            for (int j = 0; j < group->num_servers && keep_running_manager; ++j) {
-                VMSServerInfo* server = &group->servers[j];
-                int local_socket_handle;
-                int should_attempt_connection = 0;
-
-                // --- CRITICAL SECTION START (READ) ---
-                pthread_mutex_lock(&vms_servers->mutex);
-                local_socket_handle = server->socket_handle;
-                pthread_mutex_unlock(&vms_servers->mutex);
-                // --- CRITICAL SECTION END (READ) ---
-
-                if (local_socket_handle == -1) {
-                    should_attempt_connection = 1;
-                } else {
-                    if (!is_socket_alive_with_select(local_socket_handle)) {
-                        fprintf(stderr, "[ManagerThread] 연결 유실/오류 감지: 그룹 %d, %s:%d (핸들: %d). 이전 소켓 닫음.\n",
-                               server->group_id_for_log, server->ip_address, server->port, local_socket_handle);
-                        close(local_socket_handle); // 이전 핸들 닫기
-
-                        // --- CRITICAL SECTION START (WRITE) ---
-                        pthread_mutex_lock(&vms_servers->mutex);
-                        // 핸들을 닫은 후, 현재 저장된 핸들이 우리가 닫은 핸들과 같은지 확인 (매우 짧은 시간 동안 다른 스레드가 변경했을 가능성 방지)
-                        if (server->socket_handle == local_socket_handle) {
-                           server->socket_handle = -1;   // 핸들 무효화
-                        }
-                        pthread_mutex_unlock(&vms_servers->mutex);
-                        // --- CRITICAL SECTION END (WRITE) ---
-                        should_attempt_connection = 1; // 재연결 필요
-                    } else {
-                        // printf("[ManagerThread] 연결 활성 유지 중: 그룹 %d, %s:%d (핸들: %d)\n",
-                        //       server->group_id_for_log, server->ip_address, server->port, local_socket_handle);
-                    }
-                }
-                
-                if (should_attempt_connection && keep_running_manager) {
-                    printf("[ManagerThread] 연결 시도: %d번 그룹, %s:%d\n",
-                           server->group_id_for_log, server->ip_address, server->port);
-
-                    int new_sock = socket(AF_INET, SOCK_STREAM, 0);
-                    if (new_sock < 0) {
-                        fprintf(stderr, "[ManagerThread] 소켓 생성 실패 (그룹 %d, %s:%d): %s\n",
-                                server->group_id_for_log, server->ip_address, server->port, strerror(errno));
-                        continue; 
-                    }
+    printf("[ManagerThread] Starting VMS connection management loop (connect timeout %d ms)...\n",
+           vms_servers->connect_timeout_ms);
 
-                    struct sockaddr_in serv_addr;
-                    memset(&serv_addr, 0, sizeof(serv_addr));
-                    serv_addr.sin_family = AF_INET;
-                    serv_addr.sin_port = htons(server->port);
+    // 처음에는 모든 서버에 동시에 연결을 시도하고, 이후에는 타이머가 만료된 서버만 처리한다
+    for (int i = 0; i < topology->num_servers && keep_running_manager; ++i) {
+        start_connect(&eng, topology->servers[i]);
+    }
 
-                    if (inet_pton(AF_INET, server->ip_address, &serv_addr.sin_addr) <= 0) {
-                        fprintf(stderr, "[ManagerThread] 잘못된 주소 (그룹 %d): %s\n",
-                                server->group_id_for_log, server->ip_address);
-                        close(new_sock);
-                        continue;
-                    }
-                    
-                    // 블로킹 소켓이라 체크 시간이 오래 걸릴 수 있음
-                    if (connect(new_sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
-                        fprintf(stderr, "[ManagerThread] 연결 실패: %d번 그룹, %s:%d (에러: %s)\n",
-                            server->group_id_for_log, server->ip_address, server->port, strerror(errno));
-                        // server->socket_handle은 이미 -1이거나, 이전 체크에서 -1로 설정되었어야 함.
-                        close(new_sock);
-                    } else {
-                        printf("[ManagerThread] 연결 성공: %d번 그룹, %s:%d (새 핸들: %d)\n",
-                               server->group_id_for_log, server->ip_address, server->port, new_sock);
-                        // --- CRITICAL SECTION START (WRITE) ---
-                        pthread_mutex_lock(&vms_servers->mutex);
-                        // 만약 이전 핸들이 아직 남아있다면 닫아준다.
-                        if(server->socket_handle != -1 && server->socket_handle != new_sock) {
-                            close(server->socket_handle);
-                        }
-                        server->socket_handle = new_sock;
-                        pthread_mutex_unlock(&vms_servers->mutex);
-                        // --- CRITICAL SECTION END (WRITE) ---
-                    }
-                }
-                if (!keep_running_manager) break; // 서버 루프 즉시 중단
-            } // End server loop
-            if (!keep_running_manager) break; // 그룹 루프 즉시 중단
-        } // End group loop
-
-        // keep_running_manager 플래그에 더 자주 반응하기 위한 분할된 sleep
-        for (int k_sleep = 0; k_sleep < (CONNECTION_RETRY_DELAY_MS / 100) && keep_running_manager; ++k_sleep) {
-            usleep(100 * 1000); // 0.1초씩 나누어 잠
+    while (keep_running_manager) {
+        // 다음 타이머까지 대기하되, keep_running_manager 플래그에 반응하도록 최대 0.1초
+        int wait_ms = timer_wheel_next_timeout_ms(&eng.wheel, monotonic_ms(), CONNECT_POLL_SLICE_MS);
+        poll_connection_events(&eng, wait_ms);
+        timer_wheel_advance(&eng.wheel, monotonic_ms(), on_server_timer, &eng);
+        if (eng.reload_pending) {
+            eng.reload_pending = false;
+            reload_topology(&eng);
+        }
+        if (vms_servers->topology.retired) { // 전송 경로가 이전 구성을 놓을 때까지 해제를 미뤄 둔 경우
+            pthread_mutex_lock(&vms_servers->mutex);
+            reclaim_retired_locked(vms_servers);
+            pthread_mutex_unlock(&vms_servers->mutex);
         }
-    } // End while(keep_running_manager)
+    }
+
+    topology = vms_manager_topology(vms_servers);
+    for (int i = 0; i < topology->num_servers; ++i) {
+        abort_pending_connect(&eng, topology->servers[i]);
+    }
+    file_watch_close(&eng.ini_watch);
+    timer_wheel_destroy(&eng.wheel);
+    close(eng.epoll_fd);
     printf("[ManagerThread] Connection management loop finished.\n");
 }
 
 
-void vms_manager_cleanup(VMSServers* vms_servers) {
-    if (!vms_servers) return;
+bool vms_manager_start_sender(VMSServers* vms_servers, int queue_depth, bool latest_only) {
+    if (!vms_servers) return false;
+    if (vms_servers->sender) return true;
 
-    printf("Cleaning up VMS connection manager...\n");
+    VMSSender* sender = vms_sender_create();
+    if (!sender) return false;
 
-    for (int i = 0; i < vms_servers->num_groups; ++i) {
-        VMSServerGroup* group = &vms_servers->groups[i];
-        if (group->servers) {
-            for (int j = 0; j < group->num_servers; ++j) {
-                if (group->servers[j].socket_handle != -1) {
-                    printf("Closing socket for Group %d, %s:%d (Handle: %d)\n",
-                           group->servers[j].group_id_for_log, group->servers[j].ip_address,
-                           group->servers[j].port, group->servers[j].socket_handle);
-                    close(group->servers[j].socket_handle);
-                    group->servers[j].socket_handle = -1;
-                }
+    VMSTopology* topology = vms_manager_topology(vms_servers);
+    for (int i = 0; i < topology->num_servers; ++i) {
+        VMSServerInfo* server = topology->servers[i];
+        char label[VMS_SEND_QUEUE_LABEL_SIZE];
+        format_queue_label(server, label, sizeof(label));
+        if (!vms_send_queue_init(&server->send_queue, sender, queue_depth, latest_only, label)) {
+            // 이미 초기화한 큐만 되돌린다
+            vms_sender_destroy(sender);
+            for (int k = 0; k < i; ++k) vms_send_queue_destroy(&topology->servers[k]->send_queue);
+            return false;
+        }
+    }
+
+    vms_servers->sender = sender;
+    vms_servers->send_queue_depth = queue_depth;
+    vms_servers->send_latest_only = latest_only;
+    printf("[VMSManager] Send queues ready: %d servers, depth %d%s\n", topology->num_servers,
+           (queue_depth > 0) ? queue_depth : VMS_SEND_QUEUE_DEFAULT_DEPTH, latest_only ? ", latest only" : "");
+    return true;
+}
+
+void vms_manager_report_queues(VMSServers* vms_servers) {
+    if (!vms_servers || !vms_servers->sender) return;
+
+    pthread_mutex_lock(&vms_servers->mutex); // 보고하는 동안 구성이 해제되지 않도록
+    VMSTopology* topology = vms_manager_topology(vms_servers);
+
+    // 서버별 소속 그룹 (처음 포함한 그룹, 그룹 수)을 현재 구성에서 센다. 할당에 실패하면 IP:PORT만 출력
+    int* first_group = (int*)calloc((size_t)topology->num_servers + 1, sizeof(int));
+    int* member_count = (int*)calloc((size_t)topology->num_servers + 1, sizeof(int));
+    if (first_group && member_count) {
+        for (int g = 0; g < topology->num_groups; ++g) {
+            const VMSServerGroup* group = &topology->groups[g];
+            for (int k = 0; k < group->num_servers; ++k) {
+                int server_id = group->server_ids[k];
+                if (member_count[server_id]++ == 0) first_group[server_id] = group->group_id;
             }
-            free(group->servers);
-            group->servers = NULL;
         }
     }
-    if (vms_servers->groups) { // groups가 NULL일 수도 있음 (ini파일이 비었거나 파싱실패 등)
-        free(vms_servers->groups);
-        vms_servers->groups = NULL;
+
+    printf("[VMSManager] 송신 큐 상태 (구성 버전 %lu; 서버, 깊이, 최대 깊이, 전송, 대체, 폐기, 미연결, 부분 전송, 오류)\n",
+           topology->version);
+    for (int i = 0; i < topology->num_servers; ++i) {
+        VMSServerInfo* server = topology->servers[i];
+        size_t depth;
+        VMSSendQueueCounters c;
+        vms_send_queue_snapshot(&server->send_queue, &depth, &c);
+        char name[VMS_SEND_QUEUE_LABEL_SIZE + 32];
+        if (!first_group || !member_count) {
+            snprintf(name, sizeof(name), "%s", server->send_queue.label);
+        } else if (member_count[i] > 1) {
+            snprintf(name, sizeof(name), "%s (그룹 %d 외 %d개)", server->send_queue.label, first_group[i], member_count[i] - 1);
+        } else {
+            snprintf(name, sizeof(name), "%s (그룹 %d)", server->send_queue.label, first_group[i]);
+        }
+        printf("  %-32s depth=%zu high=%zu sent=%lu coalesced=%lu dropped=%lu not_connected=%lu partial=%lu errors=%lu\n",
+               name, depth, c.high_watermark, c.sent, c.coalesced, c.dropped,
+               c.not_connected, c.partial_writes, c.errors);
     }
-    
-    vms_servers->num_groups = 0;
-    vms_servers->total_servers_configured = 0;
+    pthread_mutex_unlock(&vms_servers->mutex);
+    free(first_group);
+    free(member_count);
+}
+
+// 서버 하나의 송신 큐와 소켓을 정리하고 해제한다
+static void destroy_server(VMSServerInfo* server, bool has_queue) {
+    if (has_queue) vms_send_queue_destroy(&server->send_queue);
+    int sock = atomic_load(&server->socket_handle);
+    if (sock != -1) {
+        printf("Closing socket for Group %d, %s:%d (Handle: %d)\n",
+               server->group_id_for_log, server->ip_address, server->port, sock);
+        close(sock);
+    }
+    free(server);
+}
+
+void vms_manager_cleanup(VMSServers* vms_servers) {
+    if (!vms_servers) return;
+
+    printf("Cleaning up VMS connection manager...\n");
+
+    // 송신 스레드를 먼저 멈춘 뒤 큐를 해제한다
+    VMSSender* sender = vms_servers->sender;
+    vms_servers->sender = NULL;
+    vms_sender_destroy(sender);
+
+    // 모든 서버는 현재 구성이나 parked 중 한 곳에만 있다
+    VMSTopology* topology = vms_manager_topology(vms_servers);
+    if (topology) {
+        for (int i = 0; i < topology->num_servers; ++i) destroy_server(topology->servers[i], sender != NULL);
+    }
+    for (int i = 0; i < vms_servers->num_parked; ++i) destroy_server(vms_servers->parked[i], sender != NULL);
+    free(vms_servers->parked);
+    vms_servers->parked = NULL;
+    vms_servers->num_parked = 0;
+
+    hazard_domain_destroy(&vms_servers->topology, free_topology_node);
     
     pthread_mutex_destroy(&vms_servers->mutex); // 뮤텍스 파괴
     
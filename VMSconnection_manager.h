@@ -4,34 +4,134 @@
 #define VMSCONNECTION_MANAGER_H
 
 #include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "VMSsender.h"
+#include "timer_wheel.h"
+#include "hot_reload.h"
 
-// 개별 서버 정보
+#define VMS_CONNECT_TIMEOUT_DEFAULT_MS 3000 // 연결 시도 하나의 기본 제한 시간
+
+// 재연결 정책 (vms_servers.ini 그룹별 설정)
+typedef struct {
+    int initial_delay_ms;  // 첫 재연결 대기
+    int max_delay_ms;      // 재연결 대기 상한
+    double multiplier;     // 연속 실패할 때마다 대기에 곱하는 값
+    int jitter_percent;    // 대기를 최대 이 비율만큼 무작위로 줄임 (동시에 끊긴 서버들의 재연결 분산)
+} VMSRetryPolicy;
+
+// 개별 서버(물리 VMS 표시기, IP:PORT) 정보
+// 여러 그룹이 같은 IP:PORT를 가리키면 로드할 때 하나로 합쳐 연결 하나를 공유한다.
+// 하나씩 할당하므로 구성이 바뀌어도 주소가 그대로이고, 두 구성에 모두 있는 서버는 같은 객체(소켓, 송신 큐)를 이어 쓴다.
 typedef struct {
     char ip_address[16];
     int port;
-    int socket_handle;   // TCP 연결 성공 시 소켓 디스크립터, 실패 시 -1
-    int group_id_for_log; // 로그 출력을 위한 그룹 ID
+    atomic_int socket_handle; // TCP 연결 성공 시 소켓 디스크립터, 실패 시 -1 (연결 관리 스레드만 변경, 어느 스레드나 읽기 가능)
+    int group_id_for_log; // 로그 출력을 위한 그룹 ID (이 서버를 처음 포함한 그룹)
+    int num_member_groups; // 이 서버를 포함하는 그룹 수 (연결 관리 스레드 전용)
+    VMSSendQueue send_queue; // 논블로킹 송신 큐 (vms_manager_start_sender 이후 사용). 큐의 mutex가 서버별 잠금
+    int connecting_fd;    // 진행 중인 논블로킹 connect 소켓 (없으면 -1, 연결 관리 스레드 전용)
+    // 재연결 상태 (연결 관리 스레드 전용)
+    VMSRetryPolicy retry;  // 처음 포함한 그룹 설정에서 복사한 재연결 정책
+    int connect_attempts;  // 연속 연결 실패 횟수 (연결되면 0)
+    long long next_attempt_ms; // 다음 연결 시도 시각 (CLOCK_MONOTONIC 기준 ms)
+    TimerWheelNode timer;  // 재연결 대기 또는 연결 시도 제한 시간 타이머
 } VMSServerInfo;
 
 // 서버 그룹 정보
 typedef struct {
     int group_id;          // INI 파일의 그룹 번호 (예: 1번 그룹)
-    VMSServerInfo* servers; // 해당 그룹 내 서버 정보 배열 (동적 할당)
+    int* server_ids;       // 해당 그룹 내 서버의 VMSTopology.servers 인덱스 배열 (동적 할당)
     int num_servers;       // 해당 그룹 내 서버 개수
+    VMSRetryPolicy retry;  // 그룹 재연결 정책
 } VMSServerGroup;
 
-// 전체 VMS 서버 관리 구조체
-typedef struct {
+// vms_servers.ini 한 번을 읽어 만든 그룹/서버 구성. 게시된 뒤에는 읽기 전용이다.
+// 파일이 바뀌면 연결 관리 스레드가 새 구성을 만들어 통째로 교체한다.
+typedef struct VMSTopology {
     VMSServerGroup* groups;   // 서버 그룹 배열 (동적 할당)
     int num_groups;          // 총 그룹 개수
-    int total_servers_configured; // INI 파일 통해 설정된 총 서버 개수
-    pthread_mutex_t mutex; // 공유 데이터 보호를 위한 뮤텍스
+    VMSServerInfo** servers; // 중복 없는 서버(IP:PORT) 테이블. 그룹들이 인덱스로 공유
+    int num_servers;         // 중복 없는 서버 개수
+    int total_servers_configured; // INI 파일 통해 설정된 총 서버 개수 (그룹별로 펼친 수, 중복 포함)
+    int* group_index;      // 그룹 ID 해시 테이블 (groups 인덱스, 빈 칸은 -1)
+    size_t group_index_mask;
+    unsigned long version; // 1부터 다시 읽을 때마다 1씩 증가
+    HazardNode node;       // 게시/해제 대기 목록 노드
+} VMSTopology;
+
+typedef HazardReader VMSTopologyReader; // 구성을 잠금 없이 읽는 스레드 하나의 hazard pointer
+
+// 전체 VMS 서버 관리 구조체
+typedef struct {
+    HazardDomain topology;   // 현재 구성과 교체된 구성. 전송 경로는 vms_manager_enter/leave로, 그 밖에는 mutex 아래에서 읽는다 (교체/해제도 mutex)
+    VMSServerInfo** parked;  // 설정에서 빠져 연결을 닫은 서버. 같은 IP:PORT가 다시 추가되면 재사용하고 종료 시 해제 (연결 관리 스레드 전용)
+    int num_parked;
+    char ini_filepath[256];
+    pthread_mutex_t mutex; // 구성 교체/해제와 전송 경로 밖의 구성 읽기 보호 (전송/재연결 경로는 서버별 송신 큐 잠금만 사용)
+    VMSSender* sender;     // 송신 스레드
+    int send_queue_depth;  // 새로 추가되는 서버의 송신 큐 설정 (vms_manager_start_sender에서 저장)
+    bool send_latest_only;
+    int connect_timeout_ms; // 연결 시도 하나의 제한 시간 (모든 서버에 동시에 시도하므로 전체 연결 시간도 이 값 이내)
+    bool hot_reload;        // true면 vms_servers.ini가 바뀔 때 달라진 서버만 연결/해제
+    int reload_settle_ms;   // 파일 변경 후 이 시간 동안 더 바뀌지 않으면 다시 읽음
 } VMSServers;
 
+// 그룹의 j번째 서버
+static inline VMSServerInfo* vms_group_server(const VMSTopology* topology, const VMSServerGroup* group, int j) {
+    return topology->servers[group->server_ids[j]];
+}
+
+static inline VMSTopology* vms_topology_of_node(HazardNode* node) {
+    return node ? (VMSTopology*)((char*)node - offsetof(VMSTopology, node)) : NULL;
+}
+
+// 현재 구성. 연결 관리 스레드를 시작하기 전 또는 mutex 아래에서만 사용
+static inline VMSTopology* vms_manager_topology(VMSServers* vms_servers) {
+    return vms_topology_of_node(hazard_current(&vms_servers->topology));
+}
+
 // 함수 프로토타입 선언
 VMSServers* vms_manager_init(const char* ini_filepath);
 void vms_manager_manage_connections(VMSServers* vms_servers);
 void vms_manager_cleanup(VMSServers* vms_servers); // 리소스 해제 함수
+
+/**
+ * @brief 그룹 ID로 그룹을 찾습니다. (해시 테이블, 잠금 없음)
+ * @return 그룹 포인터, 없으면 NULL.
+ */
+const VMSServerGroup* vms_manager_find_group(const VMSTopology* topology, int group_id);
+
+/**
+ * @brief 구성을 잠금 없이 읽을 스레드를 등록합니다.
+ * @return VMSTopologyReader 포인터. 자리가 없으면 NULL.
+ */
+VMSTopologyReader* vms_manager_register_reader(VMSServers* vms_servers);
+
+/**
+ * @brief 현재 구성을 잡습니다. vms_manager_leave를 호출할 때까지 해제되지 않습니다. (잠금 없음)
+ */
+const VMSTopology* vms_manager_enter(VMSServers* vms_servers, VMSTopologyReader* reader);
+
+/**
+ * @brief vms_manager_enter로 잡은 구성을 놓습니다.
+ */
+void vms_manager_leave(VMSTopologyReader* reader);
 extern volatile int keep_running_manager; // reader.c 에 정의된 전역 변수 사용
 
+/**
+ * @brief 송신 스레드를 시작하고 모든 서버의 송신 큐를 초기화합니다. 연결 관리 스레드보다 먼저 호출합니다.
+ * 구성을 다시 읽어 추가되는 서버도 같은 설정으로 송신 큐를 만듭니다.
+ * @param queue_depth 서버별 송신 큐 최대 깊이 (가득 차면 가장 오래된 미전송 패킷을 버림).
+ * @param latest_only true면 서버별로 가장 새로운 표출 패킷만 남긴다 (vms_send_queue_init 참고).
+ * @return 성공 시 true.
+ */
+bool vms_manager_start_sender(VMSServers* vms_servers, int queue_depth, bool latest_only);
+
+/**
+ * @brief 서버별 송신 큐 깊이와 전송/폐기 카운터를 출력합니다.
+ */
+void vms_manager_report_queues(VMSServers* vms_servers);
+
 #endif // VMSCONNECTION_MANAGER_H
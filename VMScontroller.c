@@ -2,20 +2,19 @@
 
 #include "VMScontroller.h"
 #include "VMSprotocol.h"
-#include "minIni.h"
+#include "ini_index.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+
+#define VMS_POOL_MAX_LISTS 16     // 재사용을 위해 보관할 최대 메시지 리스트 수
+
+_Static_assert(VMS_PACKET_BUFFER_SIZE >= VMS_TEXT_PACKET_MAX_SIZE(VMS_TEMPLATE_PAYLOAD_SIZE - 1),
+               "VMS_PACKET_BUFFER_SIZE must hold the largest template packet");
 
 // 헬퍼 함수 프로토타입 (Forward Declarations) 추가
-static double calculate_bearing(double lat1, double lon1, double lat2, double lon2);
-static double find_closest_bearing(const double* target_bearings, int count, double bearing);
-static double get_closest_target_bearing(
-    const double* target_bearings, int target_count,
-    double lat_c, double lon_c,
-    double lat_p, double lon_p
-);
 static int Change_CVIBDirCode(int cvibDirCode);
 
 bool vms_controller_load_config(const char* config_filepath, VMS_TextParamConfig_t* out_config) {
@@ -28,39 +27,74 @@ bool vms_controller_load_config(const char* config_filepath, VMS_TextParamConfig
     const char* coord_section = "기준 좌표";
     const char* dir_section = "방향 코드";
     const char* msg_section = "메시지 템플릿";
+    const char* pipeline_section = "파이프라인";
+
+    // 파일을 한 번만 읽어 색인해 두고 키마다 조회 (파일이 없으면 ini는 NULL이고 모두 기본값)
+    IniIndex* ini = ini_index_load(config_filepath);
 
     // 서버 설정
-    ini_gets(server_section, "ListenIP", "127.0.0.1", out_config->listen_ip, sizeof(out_config->listen_ip), config_filepath);
-    out_config->listen_port = (int)ini_getl(server_section, "ListenPort", 9999, config_filepath);
+    ini_index_gets(ini, server_section, "ListenIP", "127.0.0.1", out_config->listen_ip, sizeof(out_config->listen_ip));
+    out_config->listen_port = (int)ini_index_getl(ini, server_section, "ListenPort", 9999);
+    out_config->max_ingest_connections = (int)ini_index_getl(ini, server_section, "MaxConnections", 8);
+    out_config->ingest_read_budget = (int)ini_index_getl(ini, server_section, "ReadBudget", 65536);
+    ini_index_gets(ini, server_section, "DrainPolicy", "all", out_config->drain_policy, sizeof(out_config->drain_policy));
+    out_config->drain_max_frames = (int)ini_index_getl(ini, server_section, "DrainMaxFrames", 4);
+    out_config->ingest_stats_interval = (int)ini_index_getl(ini, server_section, "StatsInterval", 10);
+    ini_index_gets(ini, server_section, "JsonParser", "cjson", out_config->json_parser, sizeof(out_config->json_parser));
+    out_config->lazy_waypoints = ini_index_getbool(ini, server_section, "LazyWaypoints", 0) != 0;
+    out_config->parse_arena = ini_index_getbool(ini, server_section, "ParseArena", 1) != 0;
+    out_config->coalesce_frames = ini_index_getbool(ini, server_section, "Coalesce", 0) != 0;
+    out_config->send_queue_depth = (int)ini_index_getl(ini, server_section, "SendQueueDepth", 32);
+    out_config->send_latest_only = ini_index_getbool(ini, server_section, "SendLatestOnly", 1) != 0;
+    out_config->connect_timeout_ms = (int)ini_index_getl(ini, server_section, "ConnectTimeoutMs", 3000);
+    out_config->hot_reload = ini_index_getbool(ini, server_section, "HotReload", 1) != 0;
+    out_config->reload_settle_ms = (int)ini_index_getl(ini, server_section, "ReloadSettleMs", 200);
+
+    // 파이프라인 설정
+    out_config->pipeline_enabled = ini_index_getbool(ini, pipeline_section, "Enabled", 0) != 0;
+    out_config->pipeline_queue_depth = (int)ini_index_getl(ini, pipeline_section, "QueueDepth", 64);
+    ini_index_gets(ini, pipeline_section, "OverflowPolicy", "block", out_config->pipeline_overflow_policy, sizeof(out_config->pipeline_overflow_policy));
+    out_config->pipeline_report_interval = (int)ini_index_getl(ini, pipeline_section, "ReportInterval", 10);
 
     // 텍스트 파라미터 로드
-    ini_gets(text_section, "RST", "1", out_config->rst, sizeof(out_config->rst), config_filepath);
-    ini_gets(text_section, "SPD", "3", out_config->spd, sizeof(out_config->spd), config_filepath);
-    ini_gets(text_section, "NEN", "0", out_config->nen, sizeof(out_config->nen), config_filepath);
-    ini_gets(text_section, "LNE", "1", out_config->lne, sizeof(out_config->lne), config_filepath);
-    ini_gets(text_section, "YSZ", "2", out_config->ysz, sizeof(out_config->ysz), config_filepath);
-    ini_gets(text_section, "EFF", "090009000900", out_config->eff, sizeof(out_config->eff), config_filepath);
-    ini_gets(text_section, "DLY", "3", out_config->dly, sizeof(out_config->dly), config_filepath);
-    ini_gets(text_section, "FIX", "1", out_config->fix, sizeof(out_config->fix), config_filepath);
-    ini_gets(text_section, "DEFALT_FONT", "$f00", out_config->default_font, sizeof(out_config->default_font), config_filepath);
-    ini_gets(text_section, "DEFAULT_COLOR", "$c00", out_config->default_color, sizeof(out_config->default_color), config_filepath);
+    ini_index_gets(ini, text_section, "RST", "1", out_config->rst, sizeof(out_config->rst));
+    ini_index_gets(ini, text_section, "SPD", "3", out_config->spd, sizeof(out_config->spd));
+    ini_index_gets(ini, text_section, "NEN", "0", out_config->nen, sizeof(out_config->nen));
+    ini_index_gets(ini, text_section, "LNE", "1", out_config->lne, sizeof(out_config->lne));
+    ini_index_gets(ini, text_section, "YSZ", "2", out_config->ysz, sizeof(out_config->ysz));
+    ini_index_gets(ini, text_section, "EFF", "090009000900", out_config->eff, sizeof(out_config->eff));
+    ini_index_gets(ini, text_section, "DLY", "3", out_config->dly, sizeof(out_config->dly));
+    ini_index_gets(ini, text_section, "FIX", "1", out_config->fix, sizeof(out_config->fix));
+    ini_index_gets(ini, text_section, "DEFALT_FONT", "$f00", out_config->default_font, sizeof(out_config->default_font));
+    ini_index_gets(ini, text_section, "DEFAULT_COLOR", "$c00", out_config->default_color, sizeof(out_config->default_color));
 
     // 기준 좌표 로드
-    out_config->center_latitude = (double)ini_getf(coord_section, "CenterLatitude", 0.0, config_filepath);
-    out_config->center_longitude = (double)ini_getf(coord_section, "CenterLongitude", 0.0, config_filepath);
+    out_config->center_latitude = ini_index_getf(ini, coord_section, "CenterLatitude", 0.0);
+    out_config->center_longitude = ini_index_getf(ini, coord_section, "CenterLongitude", 0.0);
 
     // 방향 코드 로드
-    out_config->direction_codes[0] = (int)ini_getl(dir_section, "DirCode1", 45, config_filepath);
-    out_config->direction_codes[1] = (int)ini_getl(dir_section, "DirCode2", 135, config_filepath);
-    out_config->direction_codes[2] = (int)ini_getl(dir_section, "DirCode3", 225, config_filepath);
-    out_config->direction_codes[3] = (int)ini_getl(dir_section, "DirCode4", 315, config_filepath);
+    out_config->direction_codes[0] = (int)ini_index_getl(ini, dir_section, "DirCode1", 45);
+    out_config->direction_codes[1] = (int)ini_index_getl(ini, dir_section, "DirCode2", 135);
+    out_config->direction_codes[2] = (int)ini_index_getl(ini, dir_section, "DirCode3", 225);
+    out_config->direction_codes[3] = (int)ini_index_getl(ini, dir_section, "DirCode4", 315);
+    vms_sector_compile(&out_config->sectors, out_config->center_latitude, out_config->center_longitude,
+                       out_config->direction_codes);
 
     // 메시지 템플릿 로드
-    ini_gets(msg_section, "Message0", "-", out_config->msg_template0, sizeof(out_config->msg_template0), config_filepath);
-    ini_gets(msg_section, "Message1", "차량 접근(Speed:%.1f)", out_config->msg_template1, sizeof(out_config->msg_template1), config_filepath);
-    ini_gets(msg_section, "Message2", "차량 진입", out_config->msg_template2, sizeof(out_config->msg_template2), config_filepath);
-    ini_gets(msg_section, "Message3", "차량 통과 예상(Speed:%.1f)", out_config->msg_template3, sizeof(out_config->msg_template3), config_filepath);
-    ini_gets(msg_section, "Message4", "$c01주의! 충돌 위험! (PET:%.2f)", out_config->msg_template4, sizeof(out_config->msg_template4), config_filepath);
+    ini_index_gets(ini, msg_section, "Message0", "-", out_config->msg_template0, sizeof(out_config->msg_template0));
+    ini_index_gets(ini, msg_section, "Message1", "차량 접근(Speed:%.1f)", out_config->msg_template1, sizeof(out_config->msg_template1));
+    ini_index_gets(ini, msg_section, "Message2", "차량 진입", out_config->msg_template2, sizeof(out_config->msg_template2));
+    ini_index_gets(ini, msg_section, "Message3", "차량 통과 예상(Speed:%.1f)", out_config->msg_template3, sizeof(out_config->msg_template3));
+    ini_index_gets(ini, msg_section, "Message4", "$c01주의! 충돌 위험! (PET:%.2f)", out_config->msg_template4, sizeof(out_config->msg_template4));
+
+    ini_index_free(ini);
+
+    const char* const templates[VMS_NUM_MESSAGE_TEMPLATES] = {
+        out_config->msg_template0, out_config->msg_template1, out_config->msg_template2,
+        out_config->msg_template3, out_config->msg_template4
+    };
+    vms_template_compile(&out_config->message_templates, out_config->rst, out_config->spd,
+                         out_config->default_font, out_config->default_color, templates);
 
     return true;
 }
@@ -91,10 +125,8 @@ VMS_HostObjectState_List_t* vms_controller_process_json_to_state(
 
     printf("[VMSController] Processing JSON to state objects for MsgCount: %d\n", parsed_message->msg_count);
     
-    // config에서 기준 좌표 및 방향 타겟 읽기
-    double targets[] = {text_config->direction_codes[0], text_config->direction_codes[1], text_config->direction_codes[2], text_config->direction_codes[3]};
-    double lat_c = text_config->center_latitude;
-    double lon_c = text_config->center_longitude;
+    // 기준 좌표와 방향 코드로 로드 시 만든 방위 구역 분류표
+    const VMS_SectorClassifier_t* sectors = &text_config->sectors;
 
     // ApproachTrafficInfoList 순회하며 각 객체 상태 분석
     for (int i = 0; i < parsed_message->num_approach_traffic_info; ++i) {
@@ -106,12 +138,12 @@ VMS_HostObjectState_List_t* vms_controller_process_json_to_state(
         current_state->last_msg_count = parsed_message->msg_count;
 
         // 2. WayPoint 기반 방향 코드 계산
-        if (ati->host_object.num_way_points > 0) {
-            const SdsJson_WayPoint_t* first_wp = &ati->host_object.way_point_list[0];
-            const SdsJson_WayPoint_t* last_wp = &ati->host_object.way_point_list[ati->host_object.num_way_points - 1];
+        const SdsJson_WayPoint_t* first_wp = sds_json_get_waypoint(&ati->host_object, 0);
+        const SdsJson_WayPoint_t* last_wp = sds_json_get_waypoint(&ati->host_object, ati->host_object.num_way_points - 1);
+        if (first_wp && last_wp) {
             
-            int first_wp_group = (int)get_closest_target_bearing(targets, 4, lat_c, lon_c, first_wp->lat, first_wp->lon);
-            int last_wp_group = (int)get_closest_target_bearing(targets, 4, lat_c, lon_c, last_wp->lat, last_wp->lon);
+            int first_wp_group = vms_sector_classify(sectors, first_wp->lat, first_wp->lon);
+            int last_wp_group = vms_sector_classify(sectors, last_wp->lat, last_wp->lon);
             
             current_state->entry_direction_code = first_wp_group;
             current_state->egress_direction_code = last_wp_group;
@@ -131,10 +163,10 @@ VMS_HostObjectState_List_t* vms_controller_process_json_to_state(
         current_state->has_conflict = false;
         current_state->remote_obj_direction_code = 0;
 
-        if (ati->conflict_pos && ati->remote_object && ati->remote_object->num_way_points > 0) {
+        const SdsJson_WayPoint_t* remote_wp = ati->remote_object ? sds_json_get_waypoint(ati->remote_object, 0) : NULL;
+        if (ati->conflict_pos && remote_wp) {
             current_state->has_conflict = true;
-            const SdsJson_WayPoint_t* remote_wp = &ati->remote_object->way_point_list[0];
-            current_state->remote_obj_direction_code = (int)get_closest_target_bearing(targets, 4, lat_c, lon_c, remote_wp->lat, remote_wp->lon);
+            current_state->remote_obj_direction_code = vms_sector_classify(sectors, remote_wp->lat, remote_wp->lon);
         }
     }
 
@@ -150,70 +182,220 @@ void free_vms_object_state_list(VMS_HostObjectState_List_t* state_list) {
     free(state_list);
 }
 
+// 메시지 리스트 보관소 (결정 스레드와 전송 스레드가 다를 수 있어 뮤텍스로 보호)
+static struct {
+    pthread_mutex_t mutex;
+    VMS_MessageList_t* free_lists;
+    int num_free_lists;
+} g_message_pool = { PTHREAD_MUTEX_INITIALIZER, NULL, 0 };
+
+static VMS_MessageList_t* acquire_message_list(void) {
+    pthread_mutex_lock(&g_message_pool.mutex);
+    VMS_MessageList_t* list = g_message_pool.free_lists;
+    if (list) {
+        g_message_pool.free_lists = list->next_free;
+        g_message_pool.num_free_lists--;
+    }
+    pthread_mutex_unlock(&g_message_pool.mutex);
+
+    if (!list) {
+        list = (VMS_MessageList_t*)malloc(sizeof(VMS_MessageList_t));
+        if (!list) {
+            perror("Failed to allocate VMS_MessageList_t");
+            return NULL;
+        }
+    }
+    list->count = 0;
+    list->msg_count = 0;
+    list->next_free = NULL;
+    return list;
+}
+
 void free_vms_message_list(VMS_MessageList_t* message_list) {
     if (!message_list) return;
-    if (message_list->messages) {
-        for (int i = 0; i < message_list->count; ++i) {
-            if (message_list->messages[i].payload_str) {
-                free(message_list->messages[i].payload_str);
-            }
-            if (message_list->messages[i].target_group_ids) {
-                free(message_list->messages[i].target_group_ids);
-            }
-        }
-        free(message_list->messages);
+    for (int i = 0; i < message_list->count; ++i) {
+        vms_packet_buffer_release(message_list->messages[i].packet);
+        message_list->messages[i].packet = NULL;
     }
+    message_list->count = 0;
+
+    pthread_mutex_lock(&g_message_pool.mutex);
+    if (g_message_pool.num_free_lists < VMS_POOL_MAX_LISTS) {
+        message_list->next_free = g_message_pool.free_lists;
+        g_message_pool.free_lists = message_list;
+        g_message_pool.num_free_lists++;
+        message_list = NULL;
+    }
+    pthread_mutex_unlock(&g_message_pool.mutex);
     free(message_list);
 }
 
+void vms_controller_release_pools(void) {
+    pthread_mutex_lock(&g_message_pool.mutex);
+    while (g_message_pool.free_lists) {
+        VMS_MessageList_t* list = g_message_pool.free_lists;
+        g_message_pool.free_lists = list->next_free;
+        free(list);
+    }
+    g_message_pool.num_free_lists = 0;
+    pthread_mutex_unlock(&g_message_pool.mutex);
+}
 
-// 첫 번째 웨이포인트 값을 통해 그룹 번호(방위각)를 결정하는 헬퍼 함수
-#define DEG2RAD(deg) ((deg) * M_PI / 180.0)
-#define RAD2DEG(rad) ((rad) * 180.0 / M_PI)
-
-// 방위각 계산 함수
-double calculate_bearing(double lat1, double lon1, double lat2, double lon2) {
-    double dLon = DEG2RAD(lon2 - lon1);
-    lat1 = DEG2RAD(lat1);
-    lat2 = DEG2RAD(lat2);
-
-    double y = sin(dLon) * cos(lat2);
-    double x = cos(lat1) * sin(lat2) -
-               sin(lat1) * cos(lat2) * cos(dLon);
-    double brng = atan2(y, x);
-    brng = RAD2DEG(brng);
-    brng = fmod((brng + 360.0), 360.0);  // Normalize to 0–360
-    // printf("방위각 계산 결과: %f\n", brng);
-    return brng;
+void vms_controller_init_decision_state(VMS_DecisionState_t* state, const VMS_TextParamConfig_t* text_config,
+                                        const VMS_ScenarioList_t* scenario_list) {
+    memset(state, 0, sizeof(*state));
+    state->config = text_config;
+    state->scenario_list = scenario_list;
+    state->resend_all = true;
+    for (int k = 0; k < SCENARIO_NUM_GROUPS; ++k) {
+        for (int l = 0; l < SCENARIO_NUM_GROUP_LAYERS; ++l) {
+            int group_id = text_config->direction_codes[k] + 1000 * l;
+            int slot = 0;
+            while (slot < state->num_slots && state->slot_group_ids[slot] != group_id) slot++;
+            if (slot == state->num_slots) state->slot_group_ids[state->num_slots++] = group_id;
+            state->slot_of[k][l] = slot;
+        }
+    }
 }
 
-// 가장 가까운 방위각 찾기
-double find_closest_bearing(const double* target_bearings, int count, double bearing) {
-    double closest = target_bearings[0];
-    double min_diff = fabs(bearing - closest);
-    if (min_diff > 180) min_diff = 360 - min_diff;
+// 슬롯에 메시지 결정을 반영하는 함수
+// 동일한 슬롯에 더 높은 message_template_id가 들어오면 교체
+static void upsert_winning_message(VMS_GroupDecisionFrame_t* frame, const VMS_DecisionState_t* state, int slot, int message_id,
+                                   const SdsJson_ApproachTrafficInfoData_t* ati) {
+    VMS_WinningMessage_t* msg = &frame->slots[slot];
+
+    if (frame->active[slot]) {
+        // 이미 존재. 메시지 ID가 더 높을 때만 아래에서 갱신
+        if (message_id <= msg->message_template_id) return;
+    } else {
+        frame->active[slot] = true;
+        frame->order[frame->count++] = slot;
+        memset(msg, 0, sizeof(*msg));
+        msg->group_id = state->slot_group_ids[slot];
+    }
+    msg->message_template_id = message_id;
+    // 페이로드 생성에 필요한 데이터 저장
+    if(ati && ati->host_object.num_way_points > 0) {
+        msg->speed = sds_json_get_waypoint(&ati->host_object, 0)->speed;
+        msg->dir_code = ati->cvib_dir_code;
+    }
+    if(ati && ati->has_pet) {
+        msg->pet = ati->pet;
+    }
+}
 
-    for (int i = 1; i < count; ++i) {
-        double diff = fabs(bearing - target_bearings[i]);
-        if (diff > 180) diff = 360 - diff; // circular distance
+// 두 결정이 같은 패킷을 만드는지 비교 (템플릿이 사용하는 값만 비교: Message1/3은 방향 코드와 속도, Message4는 PET)
+static bool same_packet_content(const VMS_WinningMessage_t* a, const VMS_WinningMessage_t* b) {
+    if (a->message_template_id != b->message_template_id) return false;
+    switch (a->message_template_id) {
+        case 1:
+        case 3:
+            return a->dir_code == b->dir_code && memcmp(&a->speed, &b->speed, sizeof(a->speed)) == 0;
+        case 4:
+            return memcmp(&a->pet, &b->pet, sizeof(a->pet)) == 0;
+        default:
+            return true;
+    }
+}
 
-        if (diff < min_diff) {
-            min_diff = diff;
-            closest = target_bearings[i];
+VMS_MessageList_t* vms_controller_determine_messages(VMS_DecisionState_t* state, const SdsJson_MainMessage_t* parsed_message) {
+    if (!state || !parsed_message) return NULL;
+    const VMS_TextParamConfig_t* config = state->config;
+    const VMS_ScenarioList_t* scenario_list = state->scenario_list;
+
+    VMS_HostObjectState_List_t* state_list = vms_controller_process_json_to_state(parsed_message, config);
+    if (!state_list) return NULL;
+
+    VMS_GroupDecisionFrame_t* decisions = &state->decisions[state->current_decision];
+    const VMS_GroupDecisionFrame_t* prev_decisions = &state->decisions[state->current_decision ^ 1];
+    for (int i = 0; i < decisions->count; ++i) decisions->active[decisions->order[i]] = false;
+    decisions->count = 0;
+
+    for (int i = 0; i < state_list->count; ++i) {
+        VMS_HostObjectState_t* obj_state = &state_list->hostobjects[i];
+        const SdsJson_ApproachTrafficInfoData_t* original_ati = &parsed_message->approach_traffic_info_list[i];
+
+        // 객체의 방향(degree)을 시나리오 방향 코드(0~4)로 바꿔 결정 테이블에서 바로 찾는다.
+        // DirCode 설정이 겹치지 않으면 각 마스크에는 비트가 하나뿐이라 한 칸만 조회한다.
+        unsigned int entry_mask = scenario_direction_mask(config->direction_codes, obj_state->entry_direction_code);
+        unsigned int egress_mask = scenario_direction_mask(config->direction_codes, obj_state->egress_direction_code);
+        unsigned int conflict_mask = scenario_direction_mask(config->direction_codes, obj_state->has_conflict ? obj_state->remote_obj_direction_code : 0);
+
+        for (int e = 0; entry_mask >> e; ++e) {
+            if (!(entry_mask & (1u << e))) continue;
+            for (int g = 0; egress_mask >> g; ++g) {
+                if (!(egress_mask & (1u << g))) continue;
+                for (int c = 0; conflict_mask >> c; ++c) {
+                    if (!(conflict_mask & (1u << c))) continue;
+                    const VMS_ScenarioCell_t* cell = scenario_lookup(scenario_list, e, g, c);
+                    if (!cell) continue;
+
+                    for (int k = 0; k < SCENARIO_NUM_GROUPS; ++k) {
+                        for (int l = 0; l < SCENARIO_NUM_GROUP_LAYERS; ++l) {
+                            if (cell->msgs[k][l] >= 0) { upsert_winning_message(decisions, state, state->slot_of[k][l], cell->msgs[k][l], original_ati); }
+                        }
+                    }
+                }
+            }
         }
     }
+    free_vms_object_state_list(state_list);
 
-    return closest;
-}
+    VMS_MessageList_t* list = acquire_message_list();
+    if (list) {
+        list->msg_count = parsed_message->msg_count;
+        list->resend_all = state->resend_all;
+        state->resend_all = false;
+    }
 
-// 통합 헬퍼 함수
-double get_closest_target_bearing(
-    const double* target_bearings, int target_count,
-    double lat_c, double lon_c,
-    double lat_p, double lon_p
-) {
-    double bearing = calculate_bearing(lat_c, lon_c, lat_p, lon_p);
-    return find_closest_bearing(target_bearings, target_count, bearing);
+    printf("\n--- Final Messages to Send (MsgCount: %d) ---\n", parsed_message->msg_count);
+    const VMS_WinningMessage_t* list_sources[VMS_MAX_GROUP_SLOTS]; // list->messages[j]를 만든 결정
+    for (int i = 0; i < decisions->count && list; ++i) {
+        int slot = decisions->order[i];
+        const VMS_WinningMessage_t* msg = &decisions->slots[slot];
+
+        // 직전 프레임과 같은 결정도 넣는다 (여러 그룹이 공유하는 서버의 전송 여부는 송신 쪽에서 정한다)
+        bool same_msg = prev_decisions->active[slot] && prev_decisions->slots[slot].message_template_id == msg->message_template_id;
+        if (msg->message_template_id < 0 || msg->message_template_id >= VMS_NUM_MESSAGE_TEMPLATES) continue;
+
+        // 이미 같은 내용의 패킷을 만들었으면 대상 그룹만 추가
+        VMS_MessageToSend_t* out = NULL;
+        for (int j = 0; j < list->count; ++j) {
+            if (same_packet_content(list_sources[j], msg)) {
+                out = &list->messages[j];
+                break;
+            }
+        }
+        if (!out) {
+            VMS_PacketBuffer_t* packet = vms_packet_buffer_acquire();
+            if (!packet) continue;
+            out = &list->messages[list->count];
+            int packet_len = vms_template_build_packet(&config->message_templates, msg->message_template_id, CMD_TYPE_INSERT,
+                                                       msg->dir_code, msg->speed, msg->pet,
+                                                       packet->data, sizeof(packet->data),
+                                                       out->payload_str, sizeof(out->payload_str));
+            if (packet_len <= 0) {
+                fprintf(stderr, "Failed to build text control packet for group %d.\n", msg->group_id);
+                vms_packet_buffer_release(packet);
+                continue;
+            }
+            packet->len = (uint16_t)packet_len;
+            out->packet = packet;
+            out->command_type = CMD_TYPE_INSERT;
+            out->message_template_id = msg->message_template_id;
+            out->num_target_groups = 0;
+            list_sources[list->count++] = msg;
+        }
+        out->target_group_ids[out->num_target_groups++] = msg->group_id;
+        if (same_msg) {
+            printf("  ==> Same msg for Group %d\n", msg->group_id);
+        } else {
+            printf("  ==> Sending to Group %d: %s\n", msg->group_id, out->payload_str);
+        }
+    }
+
+    state->current_decision ^= 1; // 이번 결과가 다음 프레임의 비교 대상
+    return list;
 }
 
 // CVIBDirCode 방위각 변환 함수
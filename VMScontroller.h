@@ -4,6 +4,10 @@
 #define VMS_CONTROLLER_H
 
 #include "sds_json_types.h"
+#include "VMStemplate.h"
+#include "VMSsector.h"
+#include "VMSprotocol.h"
+#include "scenario_manager.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -13,6 +17,24 @@
 typedef struct {
     char listen_ip[16];
     int listen_port;
+    int max_ingest_connections;  // 동시에 접속 가능한 SDSM 송신측 수
+    int ingest_read_budget;      // 한 번의 이벤트 처리에서 연결당 최대 수신 바이트
+    char drain_policy[16];       // 완성 프레임 처리 정책 (all, latest, max)
+    int drain_max_frames;        // DrainPolicy=max일 때 wakeup당 최대 처리 프레임 수
+    int ingest_stats_interval;   // 수신 프레임 통계 출력 주기 (초, 0이면 출력 안 함)
+    char json_parser[16];        // SDSM JSON 파서 (cjson, stream, verify)
+    bool lazy_waypoints;         // true면 스트리밍 파서가 WayPoint를 읽을 때 디코딩
+    bool parse_arena;            // true면 프레임마다 아레나 하나에 파싱 결과를 할당하고 재사용
+    bool coalesce_frames;        // true면 poll 회차마다 MsgCount 기준 가장 새로운 프레임 하나만 처리
+    int send_queue_depth;        // VMS 서버별 송신 큐 크기 (가득 차면 가장 오래된 미전송 패킷을 버림)
+    bool send_latest_only;       // true면 서버별로 아직 보내지 않은 표출 패킷을 새 패킷으로 대체
+    int connect_timeout_ms;      // VMS 서버 연결 시도 하나의 제한 시간 (ms)
+    bool hot_reload;             // true면 config.ini와 시나리오 CSV가 바뀔 때 다시 읽어 적용
+    int reload_settle_ms;        // 파일 변경 후 이 시간 동안 더 바뀌지 않으면 다시 읽음 (ms)
+    bool pipeline_enabled;       // true면 recv/parse/decide/send 스테이지를 별도 스레드로 실행
+    int pipeline_queue_depth;    // 스테이지 사이 큐 크기
+    char pipeline_overflow_policy[16]; // 큐가 가득 찼을 때 정책 (block, drop_newest, drop_oldest)
+    int pipeline_report_interval; // 스테이지 통계 출력 주기 (초, 0이면 출력 안 함)
     char rst[8];
     char spd[8];
     char nen[8];
@@ -26,27 +48,65 @@ typedef struct {
     double center_latitude;
     double center_longitude;
     int direction_codes[4];
+    VMS_SectorClassifier_t sectors; // 기준 좌표와 방향 코드로 미리 만든 방위 구역 분류표 (로드 시 생성)
     char msg_template0[MAX_MSG_TEMPLATE_LEN];
     char msg_template1[MAX_MSG_TEMPLATE_LEN];
     char msg_template2[MAX_MSG_TEMPLATE_LEN];
     char msg_template3[MAX_MSG_TEMPLATE_LEN];
     char msg_template4[MAX_MSG_TEMPLATE_LEN];
+    VMS_MessageTemplates_t message_templates; // 위 파라미터와 템플릿을 미리 인코딩한 결과 (로드 시 생성)
 } VMS_TextParamConfig_t;
 
-// 전송할 페이로드와 대상 그룹 ID 목록을 담을 구조체
+#define VMS_MAX_GROUP_SLOTS (SCENARIO_NUM_GROUPS * SCENARIO_NUM_GROUP_LAYERS) // 메시지 대상 그룹 최대 수
+// 전송할 페이로드와 대상 그룹 ID 목록을 담을 구조체 (내용이 같은 그룹끼리 하나로 묶임)
 typedef struct {
-    char* payload_str;       // 실제 전송될 페이로드 문자열 (TXT= 부분 제외하고 조립된 부분)
-    int* target_group_ids;   // 이 페이로드를 전송할 그룹 ID들의 배열
+    char payload_str[VMS_TEMPLATE_PAYLOAD_SIZE];  // 로그용 페이로드 문자열 ("RST=..,SPD=..,TXT=...")
+    int target_group_ids[VMS_MAX_GROUP_SLOTS];    // 이 페이로드를 전송할 그룹 ID들의 배열
     int num_target_groups;   // 대상 그룹의 수
     uint8_t command_type;    // VMS 프로토콜의 command type (예: CMD_TYPE_INSERT)
+    int message_template_id; // 결정된 메시지 ID (여러 그룹에 속한 서버에서 우선순위 비교용, 높을수록 우선)
+    VMS_PacketBuffer_t* packet; // 한 번만 인코딩된 패킷 (리스트가 참조 하나를 가짐)
 } VMS_MessageToSend_t;
 
-// VMS_MessageToSend_t의 리스트 (동적 배열)
-typedef struct {
-    VMS_MessageToSend_t* messages;
+// 한 프레임에서 전송할 VMS_MessageToSend_t의 리스트 (사용 후 free_vms_message_list로 풀에 반환)
+typedef struct VMS_MessageList {
+    VMS_MessageToSend_t messages[VMS_MAX_GROUP_SLOTS];
     int count; // 리스트 내 메시지 수
+    int msg_count;           // 로그용 MsgCount
+    bool resend_all;         // 결정 상태를 새로 만든 뒤 첫 프레임. 서버별로 직전에 이긴 메시지와 같아도 다시 보낸다
+    struct VMS_MessageList* next_free;
 } VMS_MessageList_t;
 
+// 그룹별로 우선순위 높은 메시지 정보를 저장하는 구조체
+typedef struct {
+    int group_id;
+    int message_template_id; // 메시지 템플릿 번호 (1, 2, 3, 4...)
+    double speed;
+    double pet;
+    int dir_code;
+} VMS_WinningMessage_t;
+
+// 한 프레임의 그룹별 결정 결과 (슬롯 번호로 인덱싱)
+typedef struct {
+    VMS_WinningMessage_t slots[VMS_MAX_GROUP_SLOTS];
+    bool active[VMS_MAX_GROUP_SLOTS];   // 이 프레임에서 메시지가 결정된 슬롯
+    int order[VMS_MAX_GROUP_SLOTS];     // 처음 결정된 순서 (전송/로그 순서 유지용)
+    int count;
+} VMS_GroupDecisionFrame_t;
+
+// 프레임 사이에 유지되는 메시지 결정 상태 (한 스레드에서만 사용)
+typedef struct {
+    const VMS_TextParamConfig_t* config;
+    const VMS_ScenarioList_t* scenario_list;
+    // 시나리오가 메시지를 보낼 수 있는 대상 그룹(방향 코드 + 0/1000/2000)을 고정 슬롯 번호로 변환한 표
+    // DirCode가 겹치면 같은 그룹은 같은 슬롯을 공유한다.
+    int num_slots;
+    int slot_group_ids[VMS_MAX_GROUP_SLOTS];                            // 슬롯 -> 그룹 번호
+    int slot_of[SCENARIO_NUM_GROUPS][SCENARIO_NUM_GROUP_LAYERS];        // [A~D][1~3] -> 슬롯
+    VMS_GroupDecisionFrame_t decisions[2]; // 현재/직전 프레임의 그룹별 결정 (번갈아 사용)
+    int current_decision;                  // decisions 중 이번 프레임에 채울 쪽
+    bool resend_all;                       // 초기화 뒤 아직 리스트를 만들지 않음 (VMS_MessageList_t.resend_all)
+} VMS_DecisionState_t;
 
 // 객체 ID에 따른 정보
 typedef struct {
@@ -73,24 +133,38 @@ typedef struct {
  */
 bool vms_controller_load_config(const char* config_filepath, VMS_TextParamConfig_t* out_config);
 
+/**
+ * @brief 메시지 결정 상태를 초기화합니다. 대상 그룹을 고정 슬롯 번호로 변환해 둡니다.
+ * @param state 초기화할 결정 상태.
+ * @param text_config vms_controller_load_config 함수로 읽어온 설정 (state보다 오래 유지되어야 함).
+ * @param scenario_list load_scenarios_from_csv 함수로 읽은 시나리오 (state보다 오래 유지되어야 함).
+ */
+void vms_controller_init_decision_state(VMS_DecisionState_t* state, const VMS_TextParamConfig_t* text_config,
+                                        const VMS_ScenarioList_t* scenario_list);
+
 /**
  * @brief 파싱된 SDSM JSON 데이터와 설정을 바탕으로 VMS에 전송할 메시지 목록을 생성합니다.
+ * 그룹별 메시지를 결정하고, 내용이 같은 패킷은 한 번만 만들어 대상 그룹들을 하나의 메시지로 묶습니다.
+ * 직전 프레임과 같은 결정도 포함하므로 전송할지는 송신 쪽에서 서버별로 직전에 이긴 메시지와 비교해 정합니다.
+ * @param state vms_controller_init_decision_state로 초기화한 결정 상태.
  * @param parsed_message sds_json_parse_message 함수로부터 반환된 SdsJson_MainMessage_t 포인터.
- * @param text_config vms_controller_load_config 함수로 읽어온 텍스트 프로토콜 설정.
- * @return 생성된 VMS_MessageList_t 포인터 (동적 할당됨, 사용 후 free_vms_message_list 호출 필요).
- * 오류 발생 또는 생성할 메시지가 없으면 count가 0인 리스트나 NULL 반환 가능.
+ * @return 생성된 VMS_MessageList_t 포인터 (사용 후 free_vms_message_list 호출 필요).
+ * 보낼 메시지가 없으면 count가 0인 리스트, 객체 상태를 만들지 못하면 NULL.
  */
-VMS_MessageList_t* vms_controller_determine_messages(
-    const SdsJson_MainMessage_t* parsed_message,
-    const VMS_TextParamConfig_t* text_config
-);
+VMS_MessageList_t* vms_controller_determine_messages(VMS_DecisionState_t* state, const SdsJson_MainMessage_t* parsed_message);
 
 /**
  * @brief vms_controller_determine_messages 함수로 생성된 VMS_MessageList_t를 해제합니다.
+ * 각 메시지의 패킷 참조를 놓고 리스트는 재사용을 위해 풀로 돌려보냅니다.
  * @param message_list 해제할 VMS_MessageList_t 포인터.
  */
 void free_vms_message_list(VMS_MessageList_t* message_list);
 
+/**
+ * @brief 메시지 리스트 풀에 남은 메모리를 해제합니다. (종료 시, 모든 리스트가 해제된 뒤)
+ */
+void vms_controller_release_pools(void);
+
 VMS_HostObjectState_List_t* vms_controller_process_json_to_state(
     const SdsJson_MainMessage_t* parsed_message,
     const VMS_TextParamConfig_t* text_config
@@ -4,7 +4,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <iconv.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define VMS_PACKET_POOL_MAX 64 // 재사용을 위해 보관할 최대 패킷 버퍼 수
+
+// 패킷 버퍼 보관소 (결정, 전송, 송신 스레드가 함께 쓰므로 뮤텍스로 보호)
+static struct {
+    pthread_mutex_t mutex;
+    VMS_PacketBuffer_t* free_list;
+    int num_free;
+} g_packet_pool = { PTHREAD_MUTEX_INITIALIZER, NULL, 0 };
 
 // Little-endian으로 uint16_t 값을 버퍼에 쓰는 헬퍼 함수
 static void pack_uint16_le(uint8_t* buf, uint16_t val) {
@@ -25,56 +37,82 @@ static void pack_uint32_le(uint8_t* buf, uint32_t val) {
     buf[3] = (uint8_t)((val >> 24) & 0xFF);
 }
 
-/**
- * @brief UTF-8 문자열을 UTF-16 Little Endian 바이트 스트림으로 변환
- * @param utf8_str 변환할 UTF-8 문자열.
- * @param out_utf16_buf 변환된 UTF-16LE 데이터가 저장될 버퍼의 포인터. 함수 내에서 동적 할당
- * @param out_len_bytes 변환된 데이터의 바이트 단위 길이가 저장될 포인터.
- * @return 성공 시 0, 실패 시 -1.
- */
-static int convert_utf8_to_utf16le(const char* utf8_str, uint8_t** out_utf16_buf, size_t* out_len_bytes) {
-    iconv_t cd = iconv_open("UTF-16LE", "UTF-8");
-    if (cd == (iconv_t)-1) {
-        perror("iconv_open failed");
-        return -1;
-    }
-
-    size_t in_bytes_left = strlen(utf8_str);
-    char* in_buf_ptr = (char*)utf8_str;
-
-    // 변환 결과는 최대 (입력길이 * 2) 정도 될 수 있음. 여유롭게 할당.
-    size_t out_buf_size = (in_bytes_left + 1) * 2;
-    uint8_t* out_buf_start = (uint8_t*)malloc(out_buf_size);
-    if (!out_buf_start) {
-        perror("malloc for utf16 buffer failed");
-        iconv_close(cd);
-        return -1;
-    }
-    char* out_buf_ptr = (char*)out_buf_start;
-    size_t out_bytes_left = out_buf_size;
-
-    size_t result = iconv(cd, &in_buf_ptr, &in_bytes_left, &out_buf_ptr, &out_bytes_left);
-    iconv_close(cd);
-
-    if (result == (size_t)-1) {
-        perror("iconv conversion failed");
-        free(out_buf_start);
-        return -1;
+// UTF-8 -> UTF-16LE 변환 본체. out에는 utf8_len * 2 바이트 이상의 공간이 있어야 한다.
+// 변환하면서 쓴 바이트의 합을 *byte_sum에 더한다 (패킷 체크섬용).
+static int encode_utf16le(const uint8_t* in, size_t utf8_len, uint8_t* out, uint32_t* byte_sum) {
+    size_t i = 0;
+    size_t o = 0;
+    uint32_t sum = 0;
+
+    while (i < utf8_len) {
+#ifdef __SSE2__
+        // ASCII 16바이트 단위 변환: 상위 비트가 모두 0이면 0x00을 끼워 넣어 32바이트로 저장
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= utf8_len) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(in + i));
+            if (_mm_movemask_epi8(chunk) != 0) break;
+            _mm_storeu_si128((__m128i*)(out + o), _mm_unpacklo_epi8(chunk, zero));
+            _mm_storeu_si128((__m128i*)(out + o + 16), _mm_unpackhi_epi8(chunk, zero));
+            __m128i sad = _mm_sad_epu8(chunk, zero); // 8바이트씩 두 부분합
+            sum += (uint32_t)_mm_cvtsi128_si32(sad) + (uint32_t)_mm_extract_epi16(sad, 4);
+            i += 16;
+            o += 32;
+        }
+        if (i == utf8_len) break; // 마지막 16바이트 블록에서 끝난 경우
+#endif
+        // ASCII 한 글자
+        uint8_t c = in[i];
+        if (c < 0x80) {
+            sum += c;
+            out[o++] = c;
+            out[o++] = 0;
+            i++;
+            continue;
+        }
+
+        // 여러 바이트 문자. 잘못된 시퀀스(잘림, overlong, 서로게이트, U+10FFFF 초과)는 거부 (iconv와 동일)
+        uint32_t cp;
+        size_t need;
+        if (c >= 0xC2 && c <= 0xDF) { cp = c & 0x1F; need = 1; }
+        else if (c >= 0xE0 && c <= 0xEF) { cp = c & 0x0F; need = 2; }
+        else if (c >= 0xF0 && c <= 0xF4) { cp = c & 0x07; need = 3; }
+        else return -1;
+
+        if (utf8_len - i <= need) return -1; // 뒷 바이트가 잘림
+        for (size_t k = 1; k <= need; ++k) {
+            uint8_t cc = in[i + k];
+            if ((cc & 0xC0) != 0x80) return -1;
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        if ((need == 2 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) ||
+            (need == 3 && (cp < 0x10000 || cp > 0x10FFFF))) {
+            return -1;
+        }
+        i += need + 1;
+
+        if (cp < 0x10000) {
+            sum += (cp & 0xFF) + (cp >> 8);
+            out[o++] = (uint8_t)(cp & 0xFF);
+            out[o++] = (uint8_t)(cp >> 8);
+        } else {
+            // 4바이트 UTF-8(4) -> 서로게이트 쌍(4)이므로 out_capacity 안에 들어감
+            cp -= 0x10000;
+            uint16_t hi = (uint16_t)(0xD800 | (cp >> 10));
+            uint16_t lo = (uint16_t)(0xDC00 | (cp & 0x3FF));
+            pack_uint16_le(&out[o], hi);
+            pack_uint16_le(&out[o + 2], lo);
+            sum += (hi & 0xFF) + (hi >> 8) + (lo & 0xFF) + (lo >> 8);
+            o += 4;
+        }
     }
-
-    *out_utf16_buf = out_buf_start;
-    *out_len_bytes = out_buf_size - out_bytes_left;
-    return 0;
+    *byte_sum += sum;
+    return (int)o;
 }
 
-// M30 전광판 제어 프로토콜용 체크섬 계산 [cite: 14]
-// (STX + Type + Length(2B) + Data(n bytes))
-static uint8_t calculate_text_control_checksum(const uint8_t* buffer_stx_to_data, uint16_t length_stx_to_data) {
-    uint8_t checksum = 0;
-    for (uint16_t i = 0; i < length_stx_to_data; ++i) {
-        checksum += buffer_stx_to_data[i];
-    }
-    return checksum;
+int vms_utf8_to_utf16le(const char* utf8_str, size_t utf8_len, uint8_t* out, size_t out_capacity) {
+    uint32_t unused_sum = 0;
+    if (out_capacity < utf8_len * 2) return -1; // 최악의 경우(전부 ASCII)를 담을 수 있어야 함
+    return encode_utf16le((const uint8_t*)utf8_str, utf8_len, out, &unused_sum);
 }
 
 // 이미지 전송 프로토콜용 체크섬 계산 [cite: 2]
@@ -89,41 +127,100 @@ static uint8_t calculate_image_checksum(const uint8_t* buffer_cmd_to_data, uint3
     return checksum;
 }
 
-uint8_t* create_text_control_packet(uint8_t command_type, const char* data_str, uint16_t* out_packet_len) {
-    // 1. DATA 필드 실제 바이트 스트림 생성 (UTF-8 -> UTF-16LE 변환)
-    uint8_t* data_field_bytes = NULL;
-    size_t actual_data_field_len = 0;
-    if (convert_utf8_to_utf16le(data_str, &data_field_bytes, &actual_data_field_len) != 0) {
-        fprintf(stderr, "Failed to convert data string to UTF-16LE.\n");
-        return NULL;
+VMS_PacketBuffer_t* vms_packet_buffer_acquire(void) {
+    pthread_mutex_lock(&g_packet_pool.mutex);
+    VMS_PacketBuffer_t* packet = g_packet_pool.free_list;
+    if (packet) {
+        g_packet_pool.free_list = packet->next_free;
+        g_packet_pool.num_free--;
     }
+    pthread_mutex_unlock(&g_packet_pool.mutex);
 
-    // 2. 전체 패킷 길이 계산
-    uint16_t total_packet_len = 1 + 1 + 2 + actual_data_field_len + 1 + 1;
-    uint8_t* packet = (uint8_t*)malloc(total_packet_len);
     if (!packet) {
-        perror("Failed to allocate memory for packet");
-        free(data_field_bytes);
-        return NULL;
+        packet = (VMS_PacketBuffer_t*)malloc(sizeof(VMS_PacketBuffer_t));
+        if (!packet) {
+            perror("Failed to allocate VMS_PacketBuffer_t");
+            return NULL;
+        }
     }
+    atomic_init(&packet->refcount, 1);
+    packet->len = 0;
+    packet->next_free = NULL;
+    return packet;
+}
 
-    // 3. 패킷 필드 채우기
-    uint16_t current_idx = 0;
-    packet[current_idx++] = TEXT_CONTROL_STX;
-    packet[current_idx++] = command_type;
-    pack_uint16_le(&packet[current_idx], (uint16_t)actual_data_field_len); // LENGTH
-    current_idx += 2;
-    memcpy(&packet[current_idx], data_field_bytes, actual_data_field_len); // DATA
-    current_idx += actual_data_field_len;
+VMS_PacketBuffer_t* vms_packet_buffer_retain(VMS_PacketBuffer_t* packet) {
+    if (packet) atomic_fetch_add_explicit(&packet->refcount, 1, memory_order_relaxed);
+    return packet;
+}
 
-    // 4. 체크섬 계산
-    uint16_t len_for_checksum = 1 + 1 + 2 + actual_data_field_len;
-    packet[current_idx++] = calculate_text_control_checksum(packet, len_for_checksum);
+void vms_packet_buffer_release(VMS_PacketBuffer_t* packet) {
+    if (!packet) return;
+    if (atomic_fetch_sub_explicit(&packet->refcount, 1, memory_order_acq_rel) != 1) return;
 
-    packet[current_idx++] = TEXT_CONTROL_ETX;
+    pthread_mutex_lock(&g_packet_pool.mutex);
+    if (g_packet_pool.num_free < VMS_PACKET_POOL_MAX) {
+        packet->next_free = g_packet_pool.free_list;
+        g_packet_pool.free_list = packet;
+        g_packet_pool.num_free++;
+        packet = NULL;
+    }
+    pthread_mutex_unlock(&g_packet_pool.mutex);
+    free(packet);
+}
 
-    free(data_field_bytes); // 변환에 사용된 버퍼 해제
-    *out_packet_len = total_packet_len;
+void vms_packet_buffer_pool_release(void) {
+    pthread_mutex_lock(&g_packet_pool.mutex);
+    while (g_packet_pool.free_list) {
+        VMS_PacketBuffer_t* packet = g_packet_pool.free_list;
+        g_packet_pool.free_list = packet->next_free;
+        free(packet);
+    }
+    g_packet_pool.num_free = 0;
+    pthread_mutex_unlock(&g_packet_pool.mutex);
+}
+
+int vms_build_text_control_packet(uint8_t command_type, const char* data_str, size_t data_len,
+                                  uint8_t* out, size_t out_capacity) {
+    if (out_capacity < VMS_TEXT_PACKET_MAX_SIZE(data_len) || VMS_TEXT_PACKET_MAX_SIZE(data_len) > UINT16_MAX) {
+        return -1;
+    }
+
+    // DATA 필드에 바로 변환하면서 체크섬(STX + Type + Length + Data)을 함께 누적
+    uint32_t checksum = TEXT_CONTROL_STX + command_type;
+    int converted = encode_utf16le((const uint8_t*)data_str, data_len, &out[4], &checksum);
+    if (converted < 0) return -1;
+    uint16_t data_field_len = (uint16_t)converted;
+
+    out[0] = TEXT_CONTROL_STX;
+    out[1] = command_type;
+    pack_uint16_le(&out[2], data_field_len); // LENGTH
+    checksum += out[2] + out[3];
+    out[4 + data_field_len] = (uint8_t)checksum;
+    out[5 + data_field_len] = TEXT_CONTROL_ETX;
+    return 1 + 1 + 2 + data_field_len + 1 + 1;
+}
+
+uint8_t* create_text_control_packet(uint8_t command_type, const char* data_str, uint16_t* out_packet_len) {
+    size_t data_len = strlen(data_str);
+    size_t capacity = VMS_TEXT_PACKET_MAX_SIZE(data_len);
+    if (capacity > UINT16_MAX) {
+        fprintf(stderr, "Data string too long for text control packet (%zu bytes).\n", data_len);
+        return NULL;
+    }
+    uint8_t* packet = (uint8_t*)malloc(capacity);
+    if (!packet) {
+        perror("Failed to allocate memory for packet");
+        return NULL;
+    }
+
+    int packet_len = vms_build_text_control_packet(command_type, data_str, data_len, packet, capacity);
+    if (packet_len < 0) {
+        fprintf(stderr, "Failed to convert data string to UTF-16LE.\n");
+        free(packet);
+        return NULL;
+    }
+    *out_packet_len = (uint16_t)packet_len;
     return packet;
 }
 
@@ -5,11 +5,27 @@
 
 #include <stdint.h> // for uint8_t, uint16_t, int16_t, uint32_t
 #include <stddef.h> // for size_t
+#include <stdatomic.h>
 
 // M30 전광판 제어 프로토콜 (문자/제어) 관련 상수
 #define TEXT_CONTROL_STX 0x02
 #define TEXT_CONTROL_ETX 0x03
 
+// 문자/제어 패킷 크기: STX(1) + Type(1) + Length(2) + Data(UTF-16LE) + Checksum(1) + ETX(1)
+// UTF-16LE 데이터는 UTF-8 바이트 수의 2배를 넘지 않으므로, utf8_len 바이트 문자열의 최대 패킷 크기
+#define VMS_TEXT_PACKET_MAX_SIZE(utf8_len) (1 + 1 + 2 + (size_t)(utf8_len) * 2 + 1 + 1)
+
+// 공유 패킷 버퍼 크기 (템플릿 페이로드 최대 1023바이트 기준, VMS_TEMPLATE_PAYLOAD_SIZE 참고)
+#define VMS_PACKET_BUFFER_SIZE VMS_TEXT_PACKET_MAX_SIZE(1024 - 1)
+
+// 여러 그룹과 서버 송신 큐가 함께 쓰는 패킷 버퍼. 마지막 참조가 해제되면 풀로 돌아간다.
+typedef struct VMS_PacketBuffer {
+    atomic_int refcount;
+    uint16_t len;
+    struct VMS_PacketBuffer* next_free;
+    uint8_t data[VMS_PACKET_BUFFER_SIZE];
+} VMS_PacketBuffer_t;
+
 // 예시 명령어 타입
 #define CMD_TYPE_INSERT      0x84 // 광고 추가
 #define CMD_TYPE_POWER       0x86 // 전원 ON/OFF
@@ -38,6 +54,51 @@ typedef struct {
     int16_t height;    // 이미지 표출 세로 크기
 } IMAGE_HEADER;
 
+/**
+ * @brief UTF-8 문자열을 UTF-16 Little Endian 바이트 스트림으로 변환해 out에 씁니다. (BOM 없음)
+ * ASCII 구간은 SSE2로 16바이트씩 변환하고, BMP 밖의 문자는 서로게이트 쌍으로 씁니다.
+ * @param utf8_str 변환할 UTF-8 문자열.
+ * @param utf8_len utf8_str의 바이트 길이.
+ * @param out 변환 결과를 쓸 버퍼.
+ * @param out_capacity out의 크기. utf8_len * 2 이상이어야 합니다.
+ * @return 성공 시 쓴 바이트 수, 잘못된 UTF-8이거나 버퍼가 작으면 -1.
+ */
+int vms_utf8_to_utf16le(const char* utf8_str, size_t utf8_len, uint8_t* out, size_t out_capacity);
+
+/**
+ * @brief 풀에서 패킷 버퍼를 하나 가져옵니다. (참조 수 1)
+ * @return 패킷 버퍼, 메모리가 없으면 NULL.
+ */
+VMS_PacketBuffer_t* vms_packet_buffer_acquire(void);
+
+/**
+ * @brief 패킷 버퍼의 참조를 하나 늘립니다. (전송을 다른 스레드에 맡길 때)
+ */
+VMS_PacketBuffer_t* vms_packet_buffer_retain(VMS_PacketBuffer_t* packet);
+
+/**
+ * @brief 패킷 버퍼의 참조를 하나 줄이고, 마지막 참조였으면 풀로 돌려보냅니다.
+ */
+void vms_packet_buffer_release(VMS_PacketBuffer_t* packet);
+
+/**
+ * @brief 패킷 버퍼 풀에 남은 메모리를 해제합니다. (종료 시, 모든 버퍼가 반환된 뒤)
+ */
+void vms_packet_buffer_pool_release(void);
+
+/**
+ * @brief M30 전광판 문자/제어 패킷을 호출자가 준 버퍼에 바로 만듭니다. (힙 할당 없음)
+ * 문자열을 UTF-16LE로 변환하면서 체크섬을 함께 계산하므로 한 번만 훑습니다.
+ * @param command_type 프로토콜의 명령어 (예: CMD_TYPE_INSERT)
+ * @param data_str DATA 필드에 들어갈 UTF-8 문자열.
+ * @param data_len data_str의 바이트 길이.
+ * @param out 패킷을 쓸 버퍼.
+ * @param out_capacity out의 크기. VMS_TEXT_PACKET_MAX_SIZE(data_len) 이상이어야 합니다.
+ * @return 성공 시 패킷 길이, 버퍼가 작거나 잘못된 UTF-8이면 -1.
+ */
+int vms_build_text_control_packet(uint8_t command_type, const char* data_str, size_t data_len,
+                                  uint8_t* out, size_t out_capacity);
+
 /**
  * @brief M30 전광판 제어 프로토콜에 맞는 패킷을 생성합니다. (문자/제어용)
  * @param command_type 프로토콜의 명령어 (예: CMD_TYPE_INSERT, CMD_TYPE_POWER)
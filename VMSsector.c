@@ -0,0 +1,201 @@
+// VMSsector.c
+
+#include "VMSsector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define DEG2RAD(deg) ((deg) * M_PI / 180.0)
+#define RAD2DEG(rad) ((rad) * 180.0 / M_PI)
+
+#define SECTOR_VALIDATION_STEPS 3600     // 검증할 때 한 바퀴를 나누는 수 (0.1도 간격)
+
+// 방위각 계산 함수
+static double calculate_bearing(double lat1, double lon1, double lat2, double lon2) {
+    double dLon = DEG2RAD(lon2 - lon1);
+    lat1 = DEG2RAD(lat1);
+    lat2 = DEG2RAD(lat2);
+
+    double y = sin(dLon) * cos(lat2);
+    double x = cos(lat1) * sin(lat2) -
+               sin(lat1) * cos(lat2) * cos(dLon);
+    double brng = atan2(y, x);
+    brng = RAD2DEG(brng);
+    brng = fmod((brng + 360.0), 360.0);  // Normalize to 0–360
+    return brng;
+}
+
+// 가장 가까운 방위각 찾기
+static double find_closest_bearing(const double* target_bearings, int count, double bearing) {
+    double closest = target_bearings[0];
+    double min_diff = fabs(bearing - closest);
+    if (min_diff > 180) min_diff = 360 - min_diff;
+
+    for (int i = 1; i < count; ++i) {
+        double diff = fabs(bearing - target_bearings[i]);
+        if (diff > 180) diff = 360 - diff; // circular distance
+
+        if (diff < min_diff) {
+            min_diff = diff;
+            closest = target_bearings[i];
+        }
+    }
+
+    return closest;
+}
+
+// 기존 방식: 방위각을 구해 가장 가까운 방향 코드를 찾는다
+static int classify_by_bearing(const VMS_SectorClassifier_t* c, double lat, double lon) {
+    double bearing = calculate_bearing(c->center_lat, c->center_lon, lat, lon);
+    return (int)find_closest_bearing(c->targets, c->num_targets, bearing);
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 방위각 mid 방향의 점이 각 경계의 어느 쪽에 있는지 (vms_sector_classify와 같은 식)
+static unsigned int mask_of_bearing(const VMS_SectorClassifier_t* c, double bearing) {
+    double east = sin(DEG2RAD(bearing)), north = cos(DEG2RAD(bearing));
+    unsigned int mask = 0;
+    for (int i = 0; i < c->num_boundaries; ++i) {
+        mask |= (unsigned int)(east * c->boundary_cos[i] - north * c->boundary_sin[i] >= 0.0) << i;
+    }
+    return mask;
+}
+
+// 경계 직선들이 나누는 부채꼴마다 가운데 방위각의 방향 코드를 기존 방식으로 구해 부호 조합 표에 넣는다
+static void build_mask_table(VMS_SectorClassifier_t* c, const double* boundaries) {
+    for (int m = 0; m < (1 << VMS_SECTOR_MAX_CODES); ++m) c->code_of_mask[m] = -1;
+    if (c->num_boundaries == 0) {
+        c->code_of_mask[0] = (int)c->targets[0];
+        return;
+    }
+
+    double edges[2 * VMS_SECTOR_MAX_CODES];
+    int num_edges = 0;
+    for (int i = 0; i < c->num_boundaries; ++i) {
+        edges[num_edges++] = boundaries[i];
+        edges[num_edges++] = fmod(boundaries[i] + 180.0, 360.0);
+    }
+    qsort(edges, (size_t)num_edges, sizeof(double), compare_double);
+
+    for (int i = 0; i < num_edges; ++i) {
+        double from = edges[i];
+        double to = (i + 1 < num_edges) ? edges[i + 1] : edges[0] + 360.0;
+        if (to - from < 1e-9) continue; // 겹친 경계
+        double mid = fmod((from + to) / 2.0, 360.0);
+        c->code_of_mask[mask_of_bearing(c, mid)] = (int)find_closest_bearing(c->targets, c->num_targets, mid);
+    }
+}
+
+// 방위각이 경계 중 하나에 가까운지 (이 근처는 두 방식 결과가 달라도 허용)
+static bool near_boundary(const double* boundaries, int num_boundaries, double bearing) {
+    for (int i = 0; i < num_boundaries; ++i) {
+        double diff = fabs(bearing - boundaries[i]);
+        if (diff > 180) diff = 360 - diff;
+        if (diff <= VMS_SECTOR_TOLERANCE_DEG) return true;
+    }
+    return false;
+}
+
+// 기준점에서 방위각 bearing, 거리 radius(도) 방향의 점 하나를 두 방식으로 분류해 비교한다. 경계 근처가 아닌데 다르면 false
+static bool validate_point(const VMS_SectorClassifier_t* c, const double* boundaries, double bearing, double radius) {
+    double lat = c->center_lat + radius * cos(DEG2RAD(bearing));
+    double lon = c->center_lon + radius * sin(DEG2RAD(bearing)) / c->cos_lat;
+    int fast = vms_sector_classify(c, lat, lon);
+    int reference = classify_by_bearing(c, lat, lon);
+    if (fast == reference) return true;
+    if (near_boundary(boundaries, c->num_boundaries, calculate_bearing(c->center_lat, c->center_lon, lat, lon))) return true;
+    fprintf(stderr, "[VMSSector] 검증 실패: 방위각 %.4f, 거리 %.5f도 -> 분류표 %d, 삼각함수 %d\n",
+            bearing, radius, fast, reference);
+    return false;
+}
+
+// 한 바퀴 전체와 경계 양쪽을 여러 거리에서 검증한다
+static bool validate(const VMS_SectorClassifier_t* c, const double* boundaries) {
+    static const double radii[] = { 1e-5, 1e-4, 1e-3, 1e-2, VMS_SECTOR_FAST_RANGE_DEG * 0.9 }; // 약 1m ~ 5km
+    static const double offsets[] = { -0.01, -2 * VMS_SECTOR_TOLERANCE_DEG, 2 * VMS_SECTOR_TOLERANCE_DEG, 0.01 };
+    bool ok = true;
+    for (size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); ++r) {
+        for (int step = 0; step < SECTOR_VALIDATION_STEPS; ++step) {
+            ok &= validate_point(c, boundaries, (step + 0.5) * 360.0 / SECTOR_VALIDATION_STEPS, radii[r]);
+        }
+        for (int i = 0; i < c->num_boundaries; ++i) {
+            for (size_t k = 0; k < sizeof(offsets) / sizeof(offsets[0]); ++k) {
+                ok &= validate_point(c, boundaries, fmod(boundaries[i] + offsets[k] + 360.0, 360.0), radii[r]);
+            }
+        }
+    }
+    return ok;
+}
+
+void vms_sector_compile(VMS_SectorClassifier_t* classifier, double center_lat, double center_lon,
+                        const int direction_codes[VMS_SECTOR_MAX_CODES]) {
+    VMS_SectorClassifier_t* c = classifier;
+    memset(c, 0, sizeof(*c));
+    c->center_lat = center_lat;
+    c->center_lon = center_lon;
+    c->sin_lat = sin(DEG2RAD(center_lat));
+    c->cos_lat = cos(DEG2RAD(center_lat));
+    c->num_targets = VMS_SECTOR_MAX_CODES;
+
+    // 중복을 뺀 방향 코드를 방위각 순으로 정렬 (0~359 밖의 값은 기존 방식의 원형 거리와 맞지 않아 분류표를 쓰지 않는다)
+    double sorted[VMS_SECTOR_MAX_CODES];
+    int num_sorted = 0;
+    bool in_range = true;
+    for (int i = 0; i < VMS_SECTOR_MAX_CODES; ++i) {
+        c->targets[i] = direction_codes[i];
+        if (direction_codes[i] < 0 || direction_codes[i] >= 360) in_range = false;
+        bool seen = false;
+        for (int k = 0; k < num_sorted; ++k) seen |= (sorted[k] == c->targets[i]);
+        if (!seen) sorted[num_sorted++] = c->targets[i];
+    }
+    if (!in_range || c->cos_lat < 1e-6) {
+        fprintf(stderr, "[VMSSector] 방향 코드나 기준 좌표가 범위를 벗어나 방위각을 삼각함수로 계산합니다.\n");
+        return;
+    }
+    qsort(sorted, (size_t)num_sorted, sizeof(double), compare_double);
+
+    // 이웃한 방향 코드의 중간 방위각이 구역 경계 (코드가 하나뿐이면 경계 없음)
+    double boundaries[VMS_SECTOR_MAX_CODES];
+    c->num_boundaries = (num_sorted > 1) ? num_sorted : 0;
+    for (int i = 0; i < c->num_boundaries; ++i) {
+        double next = (i + 1 < num_sorted) ? sorted[i + 1] : sorted[0] + 360.0;
+        boundaries[i] = fmod((sorted[i] + next) / 2.0, 360.0);
+        c->boundary_sin[i] = sin(DEG2RAD(boundaries[i]));
+        c->boundary_cos[i] = cos(DEG2RAD(boundaries[i]));
+    }
+    build_mask_table(c, boundaries);
+
+    c->enabled = true;
+    if (!validate(c, boundaries)) {
+        c->enabled = false;
+        fprintf(stderr, "[VMSSector] 방위 구역 분류표가 삼각함수 계산과 달라 사용하지 않습니다.\n");
+    }
+}
+
+int vms_sector_classify(const VMS_SectorClassifier_t* classifier, double lat, double lon) {
+    const VMS_SectorClassifier_t* c = classifier;
+    double dlat = lat - c->center_lat;
+    double dlon = lon - c->center_lon;
+    if (!c->enabled || fabs(dlat) > VMS_SECTOR_FAST_RANGE_DEG || fabs(dlon) > VMS_SECTOR_FAST_RANGE_DEG ||
+        (dlat == 0.0 && dlon == 0.0)) {
+        return classify_by_bearing(c, lat, lon); // 먼 점, 기준점 자체 (방위각 0)
+    }
+
+    // 기준점 주변 동/북 좌표 (방위각 식의 2차 항까지 전개. 5km 안에서 방위각 오차는 1e-5도 이하)
+    dlat = DEG2RAD(dlat);
+    dlon = DEG2RAD(dlon);
+    double north = dlat + 0.5 * c->sin_lat * c->cos_lat * dlon * dlon;
+    double east = dlon * (c->cos_lat - c->sin_lat * dlat);
+
+    unsigned int mask = 0;
+    for (int i = 0; i < c->num_boundaries; ++i) {
+        mask |= (unsigned int)(east * c->boundary_cos[i] - north * c->boundary_sin[i] >= 0.0) << i;
+    }
+    int code = c->code_of_mask[mask];
+    return (code >= 0) ? code : classify_by_bearing(c, lat, lon);
+}
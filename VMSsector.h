@@ -0,0 +1,45 @@
+// VMSsector.h
+
+#ifndef VMS_SECTOR_H
+#define VMS_SECTOR_H
+
+#include <stdbool.h>
+
+#define VMS_SECTOR_MAX_CODES 4           // [방향 코드] DirCode1 ~ DirCode4
+#define VMS_SECTOR_FAST_RANGE_DEG 0.05   // 기준점에서 위도/경도 차가 이 안(약 5km)인 점만 평면 근사로 분류
+#define VMS_SECTOR_TOLERANCE_DEG 0.001   // 검증 시 경계에서 이 각도 안의 점은 결과가 달라도 허용
+
+// 기준 좌표와 방향 코드로 미리 만든 방위 구역 분류표
+// 점마다 방위각(삼각함수)을 구해 가장 가까운 방향 코드를 찾는 대신, 기준점 주변 평면(동/북) 좌표에서
+// 구역 경계(이웃한 방향 코드의 중간 방위각) 직선 몇 개에 대한 부호만 보고 방향 코드를 고른다.
+typedef struct {
+    bool enabled;           // false면 항상 삼각함수로 계산 (방향 코드가 0~359 밖이거나 검증 실패)
+    double center_lat;
+    double center_lon;
+    double sin_lat;         // 기준 위도의 sin, cos (동/북 좌표 2차 보정용)
+    double cos_lat;
+    int num_targets;
+    double targets[VMS_SECTOR_MAX_CODES];          // 설정 순서 그대로의 방향 코드 (삼각함수 경로용)
+    int num_boundaries;
+    double boundary_sin[VMS_SECTOR_MAX_CODES];     // 구역 경계 방위각의 sin, cos
+    double boundary_cos[VMS_SECTOR_MAX_CODES];
+    int code_of_mask[1 << VMS_SECTOR_MAX_CODES];   // 경계별 부호 비트 -> 방향 코드 (-1은 나올 수 없는 조합)
+} VMS_SectorClassifier_t;
+
+/**
+ * @brief 기준 좌표와 방향 코드로 분류표를 만들고, 한 바퀴 전체를 삼각함수 계산 결과와 비교해 검증합니다.
+ * 경계 근처(VMS_SECTOR_TOLERANCE_DEG)가 아닌 곳에서 결과가 다르면 분류표를 끄고 삼각함수로 계산합니다.
+ * @param classifier 결과를 저장할 구조체.
+ * @param center_lat, center_lon 기준 좌표.
+ * @param direction_codes DirCode1 ~ DirCode4 (방위각, 도).
+ */
+void vms_sector_compile(VMS_SectorClassifier_t* classifier, double center_lat, double center_lon,
+                        const int direction_codes[VMS_SECTOR_MAX_CODES]);
+
+/**
+ * @brief 기준점에서 본 점의 방위각에 가장 가까운 방향 코드를 반환합니다.
+ * 기준점 주변(VMS_SECTOR_FAST_RANGE_DEG)은 곱셈과 부호 비교만으로, 그 밖은 삼각함수로 계산합니다.
+ */
+int vms_sector_classify(const VMS_SectorClassifier_t* classifier, double lat, double lon);
+
+#endif // VMS_SECTOR_H
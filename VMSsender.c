@@ -0,0 +1,269 @@
+// VMSsender.c
+
+#include "VMSsender.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#define VMS_SENDER_MAX_EVENTS 32
+#define VMS_SENDER_WAIT_MS 200 // 종료 플래그 확인 주기
+
+// 큐의 모든 패킷을 버린다 (mutex 잠금 상태에서 호출)
+static void drop_all_locked(VMSSendQueue* q) {
+    while (q->count > 0) {
+        vms_packet_buffer_release(q->items[q->head]);
+        q->items[q->head] = NULL;
+        q->head = (q->head + 1) % q->capacity;
+        q->count--;
+        q->counters.dropped++;
+    }
+    q->head = 0;
+    q->head_offset = 0;
+}
+
+// 아직 한 바이트도 보내지 않은 표출 패킷을 큐에서 뺀다. 다른 명령 패킷은 순서를 유지한 채 앞으로 당긴다.
+// 맨 앞 패킷을 보내는 중이면 그 패킷은 건드리지 않는다. 뺀 개수를 반환 (mutex 잠금 상태에서 호출)
+static size_t coalesce_locked(VMSSendQueue* q) {
+    size_t first = (q->head_offset > 0) ? 1 : 0;
+    size_t kept = first;
+    size_t removed = 0;
+    for (size_t i = first; i < q->count; ++i) {
+        size_t idx = (q->head + i) % q->capacity;
+        VMS_PacketBuffer_t* packet = q->items[idx];
+        q->items[idx] = NULL;
+        if (packet->len > 1 && packet->data[1] == CMD_TYPE_INSERT) {
+            vms_packet_buffer_release(packet);
+            removed++;
+        } else {
+            q->items[(q->head + kept) % q->capacity] = packet;
+            kept++;
+        }
+    }
+    q->count = kept;
+    q->counters.coalesced += removed;
+    return removed;
+}
+
+// 소켓이 쓰기 가능해지면 한 번 알려 달라고 epoll에 등록 (mutex 잠금 상태에서 호출)
+static void arm_locked(VMSSendQueue* q) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLOUT | EPOLLONESHOT;
+    ev.data.ptr = q;
+    if (epoll_ctl(q->sender->epoll_fd, q->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, q->fd, &ev) == 0) {
+        q->registered = true;
+    } else {
+        fprintf(stderr, "[VMSSender] epoll_ctl 실패 (%s): %s\n", q->label, strerror(errno));
+    }
+}
+
+static void unregister_locked(VMSSendQueue* q) {
+    if (q->registered) {
+        epoll_ctl(q->sender->epoll_fd, EPOLL_CTL_DEL, q->fd, NULL);
+        q->registered = false;
+    }
+}
+
+// 큐에 쌓인 패킷을 쓸 수 있는 만큼 쓴다. 남으면 epoll에 등록 (mutex 잠금 상태에서 호출)
+// 전송 오류가 나면 소켓을 shutdown하고 failed로 표시한다. 닫기와 재연결은 연결 관리자가 한다.
+static void flush_locked(VMSSendQueue* q) {
+    while (q->count > 0) {
+        VMS_PacketBuffer_t* packet = q->items[q->head];
+        ssize_t n = send(q->fd, packet->data + q->head_offset, packet->len - q->head_offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            q->head_offset += (size_t)n;
+            if (q->head_offset == packet->len) {
+                vms_packet_buffer_release(packet);
+                q->items[q->head] = NULL;
+                q->head = (q->head + 1) % q->capacity;
+                q->count--;
+                q->head_offset = 0;
+                q->counters.sent++;
+            }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (q->head_offset > 0) q->counters.partial_writes++;
+            arm_locked(q);
+            return;
+        }
+
+        fprintf(stderr, "[VMSSender] ERROR: %s 로 전송 실패 (에러: %s). 남은 패킷 %zu개 폐기.\n",
+                q->label, n < 0 ? strerror(errno) : "0 바이트 전송됨", q->count);
+        q->counters.errors++;
+        q->failed = true;
+        unregister_locked(q);
+        drop_all_locked(q);
+        shutdown(q->fd, SHUT_RDWR);
+        return;
+    }
+}
+
+static void* vms_sender_thread_func(void* arg) {
+    VMSSender* sender = (VMSSender*)arg;
+    struct epoll_event events[VMS_SENDER_MAX_EVENTS];
+    printf("[VMSSender] Writer thread started.\n");
+
+    while (atomic_load(&sender->running)) {
+        int n = epoll_wait(sender->epoll_fd, events, VMS_SENDER_MAX_EVENTS, VMS_SENDER_WAIT_MS);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("[VMSSender] epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            VMSSendQueue* q = (VMSSendQueue*)events[i].data.ptr;
+            pthread_mutex_lock(&q->mutex);
+            if (q->fd >= 0 && !q->failed) flush_locked(q);
+            pthread_mutex_unlock(&q->mutex);
+        }
+    }
+
+    printf("[VMSSender] Writer thread finishing.\n");
+    return NULL;
+}
+
+VMSSender* vms_sender_create(void) {
+    VMSSender* sender = (VMSSender*)calloc(1, sizeof(VMSSender));
+    if (!sender) {
+        perror("Failed to allocate VMSSender");
+        return NULL;
+    }
+    sender->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (sender->epoll_fd < 0) {
+        perror("[VMSSender] epoll_create1");
+        free(sender);
+        return NULL;
+    }
+    atomic_init(&sender->running, true);
+    if (pthread_create(&sender->thread, NULL, vms_sender_thread_func, sender) != 0) {
+        perror("[VMSSender] 송신 스레드 생성 실패");
+        close(sender->epoll_fd);
+        free(sender);
+        return NULL;
+    }
+    sender->thread_started = true;
+    return sender;
+}
+
+void vms_sender_destroy(VMSSender* sender) {
+    if (!sender) return;
+    atomic_store(&sender->running, false);
+    if (sender->thread_started) pthread_join(sender->thread, NULL);
+    close(sender->epoll_fd);
+    free(sender);
+}
+
+bool vms_send_queue_init(VMSSendQueue* queue, VMSSender* sender, int depth, bool latest_only, const char* label) {
+    memset(queue, 0, sizeof(*queue));
+    queue->fd = -1;
+    queue->sender = sender;
+    queue->latest_only = latest_only;
+    queue->capacity = (size_t)((depth > 0) ? depth : VMS_SEND_QUEUE_DEFAULT_DEPTH);
+    if (queue->capacity < VMS_SEND_QUEUE_MIN_DEPTH) queue->capacity = VMS_SEND_QUEUE_MIN_DEPTH;
+    queue->items = (VMS_PacketBuffer_t**)calloc(queue->capacity, sizeof(VMS_PacketBuffer_t*));
+    if (!queue->items) {
+        perror("Failed to allocate VMSSendQueue");
+        return false;
+    }
+    snprintf(queue->label, sizeof(queue->label), "%s", label ? label : "");
+    if (pthread_mutex_init(&queue->mutex, NULL) != 0) {
+        perror("Failed to initialize mutex for VMSSendQueue");
+        free(queue->items);
+        queue->items = NULL;
+        return false;
+    }
+    return true;
+}
+
+void vms_send_queue_destroy(VMSSendQueue* queue) {
+    if (!queue || !queue->items) return;
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->fd >= 0) unregister_locked(queue);
+    drop_all_locked(queue);
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->items);
+    queue->items = NULL;
+}
+
+void vms_send_queue_attach(VMSSendQueue* queue, int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    pthread_mutex_lock(&queue->mutex);
+    queue->fd = fd;
+    queue->failed = false;
+    queue->registered = false;
+    queue->head_offset = 0;
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+void vms_send_queue_detach(VMSSendQueue* queue) {
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->fd >= 0) unregister_locked(queue);
+    drop_all_locked(queue);
+    queue->fd = -1;
+    queue->failed = false;
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+VMSSendResult vms_send_queue_push(VMSSendQueue* queue, VMS_PacketBuffer_t* packet) {
+    VMSSendResult result = VMS_SEND_QUEUED;
+    pthread_mutex_lock(&queue->mutex);
+
+    if (queue->fd < 0 || queue->failed) {
+        queue->counters.not_connected++;
+        pthread_mutex_unlock(&queue->mutex);
+        return VMS_SEND_NOT_CONNECTED;
+    }
+
+    if (queue->latest_only && packet->len > 1 && packet->data[1] == CMD_TYPE_INSERT && queue->count > 0) {
+        if (coalesce_locked(queue) > 0) result = VMS_SEND_COALESCED;
+    }
+
+    if (queue->count == queue->capacity) {
+        // 가장 오래된 미전송 패킷을 버린다. 맨 앞 패킷을 보내는 중이면 그 다음 것을 버린다.
+        size_t victim = queue->head;
+        if (queue->head_offset > 0) {
+            victim = (queue->head + 1) % queue->capacity;
+            vms_packet_buffer_release(queue->items[victim]);
+            queue->items[victim] = queue->items[queue->head];
+        } else {
+            vms_packet_buffer_release(queue->items[victim]);
+        }
+        queue->items[queue->head] = NULL;
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        queue->counters.dropped++;
+        result = VMS_SEND_DROPPED_OLDEST;
+    }
+
+    bool was_idle = (queue->count == 0);
+    queue->items[(queue->head + queue->count) % queue->capacity] = vms_packet_buffer_retain(packet);
+    queue->count++;
+    queue->counters.enqueued++;
+    if (queue->count > queue->counters.high_watermark) queue->counters.high_watermark = queue->count;
+
+    // 큐가 비어 있었으면 송신 스레드를 기다리지 않고 바로 써 본다 (논블로킹)
+    if (was_idle) {
+        flush_locked(queue);
+        if (queue->count == 0 && !queue->failed && result == VMS_SEND_QUEUED) result = VMS_SEND_SENT;
+    }
+
+    pthread_mutex_unlock(&queue->mutex);
+    return result;
+}
+
+void vms_send_queue_snapshot(VMSSendQueue* queue, size_t* depth, VMSSendQueueCounters* counters) {
+    pthread_mutex_lock(&queue->mutex);
+    if (depth) *depth = queue->count;
+    if (counters) *counters = queue->counters;
+    pthread_mutex_unlock(&queue->mutex);
+}
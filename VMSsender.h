@@ -0,0 +1,112 @@
+// VMSsender.h
+
+#ifndef VMS_SENDER_H
+#define VMS_SENDER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "VMSprotocol.h"
+
+#define VMS_SEND_QUEUE_DEFAULT_DEPTH 32
+#define VMS_SEND_QUEUE_MIN_DEPTH 2     // 보내는 중인 맨 앞 패킷 뒤에 적어도 한 칸이 있어야 가득 찼을 때 그 패킷을 버리지 않는다
+#define VMS_SEND_QUEUE_LABEL_SIZE 64
+
+// vms_send_queue_push 결과
+typedef enum {
+    VMS_SEND_SENT = 0,        // 바로 모두 전송됨
+    VMS_SEND_QUEUED,          // 큐에 들어감 (송신 스레드가 이어서 전송)
+    VMS_SEND_DROPPED_OLDEST,  // 큐가 가득 차 가장 오래된 미전송 패킷을 버리고 넣음
+    VMS_SEND_COALESCED,       // 아직 보내지 않은 이전 표출 패킷을 대체함 (최신 값 우선 모드)
+    VMS_SEND_NOT_CONNECTED    // 연결되지 않았거나 오류 상태라 넣지 않음
+} VMSSendResult;
+
+// 송신 큐 카운터
+typedef struct {
+    unsigned long enqueued;     // 큐에 넣은 패킷 수
+    unsigned long sent;         // 끝까지 전송한 패킷 수
+    unsigned long dropped;      // 큐가 가득 차거나 연결이 끊겨 버린 패킷 수
+    unsigned long coalesced;    // 더 새로운 표출 패킷으로 대체되어 보내지 않은 패킷 수
+    unsigned long not_connected; // 연결이 없어 넣지 못한 패킷 수
+    unsigned long partial_writes; // 일부만 쓰고 EAGAIN을 만난 횟수
+    unsigned long errors;       // 전송 오류로 연결을 끊은 횟수
+    size_t high_watermark;      // 최대 큐 깊이
+} VMSSendQueueCounters;
+
+struct VMSSender;
+
+// 서버 하나의 논블로킹 소켓과 송신 큐
+// fd, 큐, 카운터는 mutex로 보호한다. 서버별 잠금이라 다른 서버의 전송/재연결과 경합하지 않는다.
+typedef struct {
+    pthread_mutex_t mutex;
+    struct VMSSender* sender;
+    int fd;                       // 연결된 소켓 (없으면 -1). 닫는 것은 연결 관리자 책임
+    bool failed;                  // 전송 오류로 연결을 끊음 (연결 관리자가 감지해 닫고 재연결)
+    bool registered;              // epoll에 등록되어 있으면 true
+    bool latest_only;             // true면 새 표출(CMD_TYPE_INSERT) 패킷이 미전송 표출 패킷을 대체
+    VMS_PacketBuffer_t** items;   // 링 버퍼 (참조를 하나씩 가짐)
+    size_t capacity;
+    size_t head;
+    size_t count;
+    size_t head_offset;           // 맨 앞 패킷에서 이미 보낸 바이트 수 (부분 전송)
+    VMSSendQueueCounters counters;
+    char label[VMS_SEND_QUEUE_LABEL_SIZE]; // 로그용 "IP:PORT" (그룹 구성은 다시 읽으면 바뀌므로 넣지 않음)
+} VMSSendQueue;
+
+// 쓰기 대기 중인 큐를 epoll로 처리하는 송신 스레드
+typedef struct VMSSender {
+    int epoll_fd;
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool running;
+} VMSSender;
+
+/**
+ * @brief 송신 스레드를 생성하고 시작합니다.
+ * @return 성공 시 VMSSender 포인터 (vms_sender_destroy로 해제), 실패 시 NULL.
+ */
+VMSSender* vms_sender_create(void);
+
+/**
+ * @brief 송신 스레드를 멈추고 해제합니다. 큐보다 먼저 해제해야 합니다.
+ */
+void vms_sender_destroy(VMSSender* sender);
+
+/**
+ * @brief 송신 큐를 초기화합니다.
+ * @param depth 큐에 보관할 최대 패킷 수 (0 이하이면 기본값, 1이면 VMS_SEND_QUEUE_MIN_DEPTH).
+ * @param latest_only true면 최신 값 우선 모드. 표시기는 가장 새로운 표출 내용만 필요하므로
+ *        새 CMD_TYPE_INSERT 패킷을 넣을 때 아직 보내지 않은 이전 CMD_TYPE_INSERT 패킷을 버린다.
+ *        일부만 전송된 패킷은 프레임이 깨지지 않도록 끝까지 보낸다. 다른 명령 패킷은 순서대로 유지.
+ * @return 성공 시 true.
+ */
+bool vms_send_queue_init(VMSSendQueue* queue, VMSSender* sender, int depth, bool latest_only, const char* label);
+
+/**
+ * @brief 남은 패킷을 버리고 큐를 해제합니다. (소켓은 닫지 않음)
+ */
+void vms_send_queue_destroy(VMSSendQueue* queue);
+
+/**
+ * @brief 새로 연결된 소켓을 큐에 연결합니다. 소켓은 논블로킹으로 전환됩니다.
+ */
+void vms_send_queue_attach(VMSSendQueue* queue, int fd);
+
+/**
+ * @brief 소켓을 큐에서 떼어내고 남은 패킷을 버립니다. 반환 후 호출자가 소켓을 닫습니다.
+ */
+void vms_send_queue_detach(VMSSendQueue* queue);
+
+/**
+ * @brief 패킷을 큐에 넣고 바로 반환합니다. 큐가 비어 있으면 그 자리에서 논블로킹으로 먼저 써 봅니다.
+ * 큐는 패킷의 참조를 하나 늘려 보관하므로 호출자는 자기 참조를 그대로 관리하면 됩니다.
+ */
+VMSSendResult vms_send_queue_push(VMSSendQueue* queue, VMS_PacketBuffer_t* packet);
+
+/**
+ * @brief 현재 큐 깊이와 카운터 사본을 가져옵니다.
+ */
+void vms_send_queue_snapshot(VMSSendQueue* queue, size_t* depth, VMSSendQueueCounters* counters);
+
+#endif // VMS_SENDER_H
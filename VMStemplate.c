@@ -0,0 +1,244 @@
+// VMStemplate.c
+
+#include "VMStemplate.h"
+#include "VMSprotocol.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define VMS_TEMPLATE_MAX_PRECISION 6
+#define VMS_TEMPLATE_NUMBER_MAX_LEN 24   // 숫자 구간 하나의 최대 길이 (부호, 정수부, 소수점, 소수부)
+#define VMS_FIXED_MAX_SCALED 1e9         // 이보다 큰 값은 곱셈 오차 때문에 snprintf로 처리
+
+static const double pow10_table[VMS_TEMPLATE_MAX_PRECISION + 1] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+
+// 정수를 10진수로 쓴다. 쓴 길이를 반환
+static int format_int(int value, char* out) {
+    char digits[12];
+    int n = 0;
+    unsigned int u = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+
+    int len = 0;
+    if (value < 0) out[len++] = '-';
+    while (n > 0) out[len++] = digits[--n];
+    return len;
+}
+
+// printf("%.Nf")와 같은 결과를 고정 소수점 정수 연산으로 만든다. 쓴 길이를 반환.
+// 값이 너무 크거나, 반올림 경계(x.5)에 가까워 결과가 달라질 수 있으면 -1 (호출자가 snprintf 사용)
+static int format_fixed(double value, int precision, char* out) {
+    if (!isfinite(value)) return -1;
+
+    double scaled = fabs(value) * pow10_table[precision];
+    if (scaled >= VMS_FIXED_MAX_SCALED) return -1;
+    double whole = floor(scaled);
+    double frac = scaled - whole;
+    if (fabs(frac - 0.5) < 1e-6) return -1; // 곱셈 오차보다 넓게 잡은 경계 구간
+    unsigned long long rounded = (unsigned long long)whole + (frac > 0.5 ? 1 : 0);
+
+    unsigned long long scale = (unsigned long long)pow10_table[precision];
+    unsigned long long int_part = rounded / scale;
+    unsigned long long frac_part = rounded % scale;
+
+    int len = 0;
+    if (signbit(value)) out[len++] = '-'; // printf는 -0.04 -> "-0.0"처럼 음수 부호를 유지
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + int_part % 10);
+        int_part /= 10;
+    } while (int_part);
+    while (n > 0) out[len++] = digits[--n];
+
+    if (precision > 0) {
+        out[len++] = '.';
+        for (int i = precision - 1; i >= 0; --i) {
+            out[len + i] = (char)('0' + frac_part % 10);
+            frac_part /= 10;
+        }
+        len += precision;
+    }
+    return len;
+}
+
+// utf8 버퍼에 쌓인 [start, end) 구간을 고정 문자열 구간으로 추가
+static bool add_literal_segment(VMS_CompiledTemplate_t* tpl, size_t start, size_t end, size_t* utf16_used) {
+    if (end == start) return true;
+    if (tpl->num_segments >= VMS_TEMPLATE_MAX_SEGMENTS) return false;
+
+    int encoded = vms_utf8_to_utf16le(&tpl->utf8[start], end - start, &tpl->utf16[*utf16_used], sizeof(tpl->utf16) - *utf16_used);
+    if (encoded < 0) return false;
+
+    VMS_TemplateSegment_t* seg = &tpl->segments[tpl->num_segments++];
+    seg->type = VMS_SEG_LITERAL;
+    seg->utf8_offset = (uint16_t)start;
+    seg->utf8_len = (uint16_t)(end - start);
+    seg->utf16_offset = (uint16_t)*utf16_used;
+    seg->utf16_len = (uint16_t)encoded;
+    seg->checksum = 0;
+    for (int i = 0; i < encoded; ++i) seg->checksum += tpl->utf16[*utf16_used + i];
+    *utf16_used += (size_t)encoded;
+    return true;
+}
+
+// 템플릿 하나를 컴파일. 지원하지 않는 서식이거나 길이 제한을 넘으면 false
+static bool compile_template(VMS_CompiledTemplate_t* tpl, int template_id, const char* prefix) {
+    // 기존 동작: Message1/3은 (방향 코드, 속도), Message4는 (PET)를 인자로, 나머지는 서식 없이 출력
+    bool has_format = (template_id == 1 || template_id == 3 || template_id == 4);
+    size_t prefix_len = strlen(prefix);
+    size_t used = prefix_len;          // utf8 버퍼 사용량
+    size_t literal_start = 0;          // 현재 고정 문자열 구간 시작
+    size_t utf16_used = 0;
+    size_t text_len = 0;               // 템플릿 부분의 최대 길이 (잘림 여부 판단용)
+    int int_args = 0, float_args = 0;
+
+    if (prefix_len >= sizeof(tpl->utf8)) return false;
+    memcpy(tpl->utf8, prefix, prefix_len);
+
+    for (const char* p = tpl->format; *p; ++p) {
+        char c = *p;
+        if (has_format && c == '%') {
+            if (p[1] == '%') {
+                c = '%';
+                p++;
+            } else {
+                // %d, %i, %f, %.Nf 만 지원
+                const char* q = p + 1;
+                int precision = -1;
+                if (*q == '.') {
+                    precision = 0;
+                    for (++q; *q >= '0' && *q <= '9'; ++q) {
+                        precision = precision * 10 + (*q - '0');
+                        if (precision > VMS_TEMPLATE_MAX_PRECISION) return false;
+                    }
+                }
+
+                VMS_TemplateSegmentType type;
+                if ((*q == 'd' || *q == 'i') && precision < 0 && template_id != 4 && int_args++ == 0) {
+                    type = VMS_SEG_DIR_CODE;
+                } else if ((*q == 'f' || *q == 'F') && float_args++ == 0) {
+                    type = (template_id == 4) ? VMS_SEG_PET : VMS_SEG_SPEED;
+                    if (precision < 0) precision = 6;
+                } else {
+                    return false;
+                }
+
+                if (!add_literal_segment(tpl, literal_start, used, &utf16_used)) return false;
+                if (tpl->num_segments >= VMS_TEMPLATE_MAX_SEGMENTS) return false;
+                VMS_TemplateSegment_t* seg = &tpl->segments[tpl->num_segments++];
+                memset(seg, 0, sizeof(*seg));
+                seg->type = type;
+                seg->precision = precision;
+                literal_start = used;
+                text_len += VMS_TEMPLATE_NUMBER_MAX_LEN;
+                p = q;
+                continue;
+            }
+        }
+        if (used + 1 >= sizeof(tpl->utf8)) return false;
+        tpl->utf8[used++] = c;
+        text_len++;
+    }
+
+    // 기존 방식의 버퍼 크기를 넘을 수 있으면(잘림) snprintf 경로로 같은 결과를 낸다
+    if (text_len >= VMS_TEMPLATE_TEXT_SIZE || prefix_len + text_len >= VMS_TEMPLATE_PAYLOAD_SIZE) return false;
+    return add_literal_segment(tpl, literal_start, used, &utf16_used);
+}
+
+void vms_template_compile(VMS_MessageTemplates_t* templates, const char* rst, const char* spd,
+                          const char* font, const char* color, const char* const formats[VMS_NUM_MESSAGE_TEMPLATES]) {
+    memset(templates, 0, sizeof(*templates));
+    snprintf(templates->prefix, sizeof(templates->prefix), "RST=%s,SPD=%s,TXT=%s%s", rst, spd, font, color);
+
+    for (int i = 0; i < VMS_NUM_MESSAGE_TEMPLATES; ++i) {
+        VMS_CompiledTemplate_t* tpl = &templates->messages[i];
+        snprintf(tpl->format, sizeof(tpl->format), "%s", formats[i] ? formats[i] : "");
+        tpl->compiled = compile_template(tpl, i, templates->prefix);
+        if (!tpl->compiled) {
+            tpl->num_segments = 0;
+            printf("[Template] Message%d is formatted with snprintf (unsupported format or too long): %s\n", i, tpl->format);
+        }
+    }
+}
+
+// 기존 방식: snprintf로 문자열을 만든 뒤 전체를 인코딩
+static int build_packet_with_snprintf(const VMS_MessageTemplates_t* templates, int template_id, uint8_t command_type,
+                                      int dir_code, double speed, double pet,
+                                      uint8_t* out, size_t out_capacity, char* payload, size_t payload_capacity) {
+    const char* format = templates->messages[template_id].format;
+    char final_text[VMS_TEMPLATE_TEXT_SIZE];
+    if (template_id == 1 || template_id == 3) {
+        snprintf(final_text, sizeof(final_text), format, dir_code, speed);
+    } else if (template_id == 4) {
+        snprintf(final_text, sizeof(final_text), format, pet);
+    } else {
+        snprintf(final_text, sizeof(final_text), "%s", format);
+    }
+    snprintf(payload, payload_capacity, "%s%s", templates->prefix, final_text);
+    return vms_build_text_control_packet(command_type, payload, strlen(payload), out, out_capacity);
+}
+
+int vms_template_build_packet(const VMS_MessageTemplates_t* templates, int template_id, uint8_t command_type,
+                              int dir_code, double speed, double pet,
+                              uint8_t* out, size_t out_capacity, char* text, size_t text_capacity) {
+    char local_text[VMS_TEMPLATE_PAYLOAD_SIZE];
+    if (!templates || template_id < 0 || template_id >= VMS_NUM_MESSAGE_TEMPLATES) return -1;
+    if (!text || text_capacity < VMS_TEMPLATE_PAYLOAD_SIZE) {
+        text = local_text;
+        text_capacity = sizeof(local_text);
+    }
+    if (out_capacity < VMS_TEXT_PACKET_MAX_SIZE(VMS_TEMPLATE_PAYLOAD_SIZE - 1)) return -1;
+
+    const VMS_CompiledTemplate_t* tpl = &templates->messages[template_id];
+    if (!tpl->compiled) {
+        return build_packet_with_snprintf(templates, template_id, command_type, dir_code, speed, pet,
+                                          out, out_capacity, text, text_capacity);
+    }
+
+    // DATA 필드: 고정 구간은 복사, 숫자 구간은 ASCII로 포맷해 바로 UTF-16LE로 확장
+    uint32_t checksum = TEXT_CONTROL_STX + command_type;
+    size_t o = 4;
+    size_t text_len = 0;
+    for (int i = 0; i < tpl->num_segments; ++i) {
+        const VMS_TemplateSegment_t* seg = &tpl->segments[i];
+        if (seg->type == VMS_SEG_LITERAL) {
+            memcpy(&out[o], &tpl->utf16[seg->utf16_offset], seg->utf16_len);
+            memcpy(&text[text_len], &tpl->utf8[seg->utf8_offset], seg->utf8_len);
+            o += seg->utf16_len;
+            text_len += seg->utf8_len;
+            checksum += seg->checksum;
+            continue;
+        }
+
+        char number[VMS_TEMPLATE_NUMBER_MAX_LEN];
+        int len;
+        if (seg->type == VMS_SEG_DIR_CODE) len = format_int(dir_code, number);
+        else len = format_fixed(seg->type == VMS_SEG_SPEED ? speed : pet, seg->precision, number);
+        if (len < 0) {
+            // 고정 소수점으로 정확히 만들 수 없는 값은 이 패킷만 snprintf로 만든다
+            return build_packet_with_snprintf(templates, template_id, command_type, dir_code, speed, pet,
+                                              out, out_capacity, text, text_capacity);
+        }
+        for (int k = 0; k < len; ++k) {
+            out[o++] = (uint8_t)number[k];
+            out[o++] = 0;
+            checksum += (uint8_t)number[k];
+            text[text_len++] = number[k];
+        }
+    }
+    text[text_len] = '\0';
+
+    uint16_t data_len = (uint16_t)(o - 4);
+    out[0] = TEXT_CONTROL_STX;
+    out[1] = command_type;
+    out[2] = (uint8_t)(data_len & 0xFF);
+    out[3] = (uint8_t)(data_len >> 8);
+    checksum += out[2] + out[3];
+    out[o++] = (uint8_t)checksum;
+    out[o++] = TEXT_CONTROL_ETX;
+    return (int)o;
+}
@@ -0,0 +1,73 @@
+// VMStemplate.h
+
+#ifndef VMS_TEMPLATE_H
+#define VMS_TEMPLATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define VMS_NUM_MESSAGE_TEMPLATES 5     // Message0 ~ Message4
+#define VMS_TEMPLATE_TEXT_SIZE 512      // 템플릿을 채운 문자열 최대 크기 (널 포함)
+#define VMS_TEMPLATE_PAYLOAD_SIZE 1024  // "RST=..,SPD=..,TXT=..." 페이로드 최대 크기 (널 포함)
+#define VMS_TEMPLATE_MAX_SEGMENTS 16
+#define VMS_TEMPLATE_FORMAT_SIZE 256
+
+// 템플릿 구간 종류
+typedef enum {
+    VMS_SEG_LITERAL = 0,    // 미리 인코딩된 고정 문자열
+    VMS_SEG_DIR_CODE,       // %d: 방향 코드
+    VMS_SEG_SPEED,          // %.Nf: 속도
+    VMS_SEG_PET             // %.Nf: PET
+} VMS_TemplateSegmentType;
+
+typedef struct {
+    VMS_TemplateSegmentType type;
+    int precision;          // 실수 구간의 소수점 자릿수
+    uint16_t utf8_offset;   // 고정 문자열 구간: utf8 버퍼 내 위치와 길이
+    uint16_t utf8_len;
+    uint16_t utf16_offset;  // 고정 문자열 구간: utf16 버퍼 내 위치와 길이
+    uint16_t utf16_len;
+    uint32_t checksum;      // 고정 문자열 구간의 UTF-16LE 바이트 합
+} VMS_TemplateSegment_t;
+
+// 페이로드 하나("RST=..,SPD=..,TXT=<폰트><색상><템플릿>")를 고정 구간과 숫자 구간으로 나눈 결과
+typedef struct {
+    bool compiled;          // false면 snprintf로 만든다 (지원하지 않는 서식 등)
+    int num_segments;
+    VMS_TemplateSegment_t segments[VMS_TEMPLATE_MAX_SEGMENTS];
+    char utf8[VMS_TEMPLATE_PAYLOAD_SIZE];
+    uint8_t utf16[VMS_TEMPLATE_PAYLOAD_SIZE * 2];
+    char format[VMS_TEMPLATE_FORMAT_SIZE]; // 원본 템플릿 (snprintf 경로용)
+} VMS_CompiledTemplate_t;
+
+// [메시지 템플릿] 전체를 미리 컴파일한 결과
+typedef struct {
+    char prefix[VMS_TEMPLATE_PAYLOAD_SIZE]; // "RST=..,SPD=..,TXT=<폰트><색상>"
+    VMS_CompiledTemplate_t messages[VMS_NUM_MESSAGE_TEMPLATES];
+} VMS_MessageTemplates_t;
+
+/**
+ * @brief 메시지 템플릿을 고정 구간(UTF-16LE로 미리 인코딩, 체크섬 부분합 포함)과 숫자 구간으로 컴파일합니다.
+ * Message1/3은 %d(방향 코드)와 %.Nf(속도), Message4는 %.Nf(PET)를 숫자 구간으로 만들고,
+ * Message0/2는 서식 없이 그대로 출력합니다. 그 밖의 서식이 있으면 해당 템플릿은 snprintf로 처리합니다.
+ * @param templates 컴파일 결과를 저장할 구조체.
+ * @param rst, spd, font, color 페이로드 앞부분에 들어갈 텍스트 프로토콜 파라미터.
+ * @param formats Message0 ~ Message4 템플릿 문자열.
+ */
+void vms_template_compile(VMS_MessageTemplates_t* templates, const char* rst, const char* spd,
+                          const char* font, const char* color, const char* const formats[VMS_NUM_MESSAGE_TEMPLATES]);
+
+/**
+ * @brief 템플릿 번호와 동적 값으로 문자/제어 패킷을 out에 만듭니다. (힙 할당 없음)
+ * 고정 구간은 미리 인코딩된 바이트를 복사하고, 숫자만 새로 포맷해 인코딩합니다.
+ * 결과는 기존 snprintf + UTF-16LE 변환 방식과 바이트 단위로 같습니다.
+ * @param out 패킷을 쓸 버퍼. VMS_TEXT_PACKET_MAX_SIZE(VMS_TEMPLATE_PAYLOAD_SIZE - 1) 이상.
+ * @param text 로그용 UTF-8 페이로드를 쓸 버퍼 (NULL 가능). VMS_TEMPLATE_PAYLOAD_SIZE 이상.
+ * @return 성공 시 패킷 길이, 템플릿 번호가 잘못되었거나 변환에 실패하면 -1.
+ */
+int vms_template_build_packet(const VMS_MessageTemplates_t* templates, int template_id, uint8_t command_type,
+                              int dir_code, double speed, double pet,
+                              uint8_t* out, size_t out_capacity, char* text, size_t text_capacity);
+
+#endif // VMS_TEMPLATE_H
@@ -0,0 +1,144 @@
+// utf16_bench.c
+// create_text_control_packet의 UTF-8 -> UTF-16LE 변환을 기존 iconv 방식과 비교하는 마이크로벤치마크
+// 빌드/실행: make && ./utf16_bench [반복 횟수]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iconv.h>
+#include "VMSprotocol.h"
+#include "VMStemplate.h"
+
+#define DEFAULT_ITERATIONS 200000
+
+// config.ini 기본 템플릿으로 만든 실제 페이로드와 비슷한 문자열
+static const char* samples[] = {
+    "RST=1,SPD=3,TXT=$f00$c00차량 접근(Speed:23.4)",
+    "RST=1,SPD=3,TXT=$f00$c00차량 진입",
+    "RST=1,SPD=3,TXT=$f00$c00차량 통과 예상(Speed:41.0)",
+    "RST=1,SPD=3,TXT=$f00$c00-",
+    "RST=1,SPD=3,TXT=$f00$c00보행자 주의 PET 2.5s 😀",
+    "RST=1,SPD=3,TXT=",                    // 16바이트 ASCII (SSE2 블록 하나로 끝남)
+    "RST=1,SPD=3,TXT=$f00$c00-ABCDEFG",    // 32바이트 ASCII (SSE2 블록 두 개로 끝남)
+};
+#define NUM_SAMPLES ((int)(sizeof(samples) / sizeof(samples[0])))
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 변경 전 VMSprotocol.c의 변환 방식 (패킷마다 iconv_open/iconv_close, 임시 버퍼 할당)
+static int iconv_utf8_to_utf16le(const char* utf8_str, uint8_t** out_buf, size_t* out_len) {
+    iconv_t cd = iconv_open("UTF-16LE", "UTF-8");
+    if (cd == (iconv_t)-1) return -1;
+
+    size_t in_left = strlen(utf8_str);
+    char* in_ptr = (char*)utf8_str;
+    size_t out_size = (in_left + 1) * 2;
+    uint8_t* out_start = (uint8_t*)malloc(out_size);
+    if (!out_start) {
+        iconv_close(cd);
+        return -1;
+    }
+    char* out_ptr = (char*)out_start;
+    size_t out_left = out_size;
+
+    size_t result = iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left);
+    iconv_close(cd);
+    if (result == (size_t)-1) {
+        free(out_start);
+        return -1;
+    }
+    *out_buf = out_start;
+    *out_len = out_size - out_left;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int iterations = (argc > 1) ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations <= 0) iterations = DEFAULT_ITERATIONS;
+
+    // 1. 결과 비교
+    for (int s = 0; s < NUM_SAMPLES; ++s) {
+        uint8_t* expected = NULL;
+        size_t expected_len = 0;
+        uint8_t actual[1024];
+        if (iconv_utf8_to_utf16le(samples[s], &expected, &expected_len) != 0) {
+            fprintf(stderr, "iconv failed for sample %d\n", s);
+            return 1;
+        }
+        int actual_len = vms_utf8_to_utf16le(samples[s], strlen(samples[s]), actual, sizeof(actual));
+        if (actual_len != (int)expected_len || memcmp(actual, expected, expected_len) != 0) {
+            fprintf(stderr, "MISMATCH for sample %d: \"%s\"\n", s, samples[s]);
+            free(expected);
+            return 1;
+        }
+        free(expected);
+    }
+    printf("All %d samples match iconv output.\n", NUM_SAMPLES);
+
+    // 2. 변환만 측정
+    volatile size_t sink = 0;
+    double t0 = now_sec();
+    for (int n = 0; n < iterations; ++n) {
+        uint8_t* buf = NULL;
+        size_t len = 0;
+        if (iconv_utf8_to_utf16le(samples[n % NUM_SAMPLES], &buf, &len) == 0) {
+            sink += len;
+            free(buf);
+        }
+    }
+    double t_iconv = now_sec() - t0;
+
+    t0 = now_sec();
+    for (int n = 0; n < iterations; ++n) {
+        uint8_t buf[1024];
+        const char* str = samples[n % NUM_SAMPLES];
+        sink += (size_t)vms_utf8_to_utf16le(str, strlen(str), buf, sizeof(buf));
+    }
+    double t_inline = now_sec() - t0;
+
+    // 3. 패킷 생성 전체
+    t0 = now_sec();
+    for (int n = 0; n < iterations; ++n) {
+        uint16_t len = 0;
+        uint8_t* packet = create_text_control_packet(CMD_TYPE_INSERT, samples[n % NUM_SAMPLES], &len);
+        sink += len;
+        free(packet);
+    }
+    double t_packet = now_sec() - t0;
+
+    t0 = now_sec();
+    for (int n = 0; n < iterations; ++n) {
+        uint8_t packet[VMS_TEXT_PACKET_MAX_SIZE(256)];
+        const char* str = samples[n % NUM_SAMPLES];
+        sink += (size_t)vms_build_text_control_packet(CMD_TYPE_INSERT, str, strlen(str), packet, sizeof(packet));
+    }
+    double t_build = now_sec() - t0;
+
+    // 4. 미리 컴파일한 템플릿 (config.ini 기본 템플릿, 숫자만 포맷)
+    static VMS_MessageTemplates_t templates;
+    const char* const formats[VMS_NUM_MESSAGE_TEMPLATES] = {
+        "-", "차량 접근(Speed:%.1f)", "차량 진입", "차량 통과 예상(Speed:%.1f)", "$c01주의! 충돌 위험! (PET:%.2f)"
+    };
+    vms_template_compile(&templates, "1", "3", "$f00", "$c00", formats);
+    t0 = now_sec();
+    for (int n = 0; n < iterations; ++n) {
+        uint8_t packet[VMS_TEXT_PACKET_MAX_SIZE(VMS_TEMPLATE_PAYLOAD_SIZE - 1)];
+        sink += (size_t)vms_template_build_packet(&templates, n % VMS_NUM_MESSAGE_TEMPLATES, CMD_TYPE_INSERT,
+                                                  45, n * 0.01, 2.5, packet, sizeof(packet), NULL, 0);
+    }
+    double t_template = now_sec() - t0;
+
+    printf("iterations: %d\n", iterations);
+    printf("  iconv (open/convert/close) : %8.1f ns/string\n", t_iconv * 1e9 / iterations);
+    printf("  vms_utf8_to_utf16le        : %8.1f ns/string\n", t_inline * 1e9 / iterations);
+    printf("  create_text_control_packet : %8.1f ns/packet\n", t_packet * 1e9 / iterations);
+    printf("  vms_build_text_control_packet (caller buffer) : %8.1f ns/packet\n", t_build * 1e9 / iterations);
+    printf("  vms_template_build_packet (compiled template) : %8.1f ns/packet\n", t_template * 1e9 / iterations);
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,229 @@
+// config_reloader.c
+
+#include "config_reloader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stddef.h>
+#include <time.h>
+#include <poll.h>
+
+#define CONFIG_RELOADER_WAIT_MS 200 // 종료 플래그 확인 및 해제 대기 스냅샷 재확인 주기
+
+static long long monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static VMS_ConfigSnapshot_t* snapshot_of_node(HazardNode* node) {
+    return (VMS_ConfigSnapshot_t*)((char*)node - offsetof(VMS_ConfigSnapshot_t, node));
+}
+
+static void free_snapshot(VMS_ConfigSnapshot_t* snapshot) {
+    if (!snapshot) return;
+    free_scenario_list(snapshot->scenario_list);
+    free(snapshot);
+}
+
+static void free_snapshot_node(HazardNode* node) {
+    free_snapshot(snapshot_of_node(node));
+}
+
+// 두 파일을 읽어 새 스냅샷을 만든다. 하나라도 읽지 못하면 NULL
+static VMS_ConfigSnapshot_t* build_snapshot(const ConfigReloader* reloader, unsigned long version) {
+    // 편집기가 파일을 바꿔치는 사이에 읽으면 모든 값이 기본값이 되므로, 열 수 없으면 다시 읽지 않는다
+    FILE* probe = fopen(reloader->config_path, "r");
+    if (!probe) {
+        fprintf(stderr, "[ConfigReloader] %s 를 열 수 없습니다: %s\n", reloader->config_path, strerror(errno));
+        return NULL;
+    }
+    fclose(probe);
+
+    VMS_ConfigSnapshot_t* snapshot = (VMS_ConfigSnapshot_t*)calloc(1, sizeof(VMS_ConfigSnapshot_t));
+    if (!snapshot) {
+        perror("Failed to allocate VMS_ConfigSnapshot_t");
+        return NULL;
+    }
+    snapshot->version = version;
+    if (!vms_controller_load_config(reloader->config_path, &snapshot->config)) {
+        free(snapshot);
+        return NULL;
+    }
+    snapshot->scenario_list = load_scenarios_from_csv(reloader->scenario_path);
+    if (!snapshot->scenario_list) {
+        free(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+// 읽는 스레드가 hazard에 걸어 두지 않은 해제 대기 스냅샷을 해제한다 (리로드 스레드 전용)
+static void reclaim_retired(ConfigReloader* reloader) {
+    unsigned long pending = hazard_reclaim(&reloader->snapshots, free_snapshot_node);
+    atomic_store_explicit(&reloader->stats.retired_pending, pending, memory_order_relaxed);
+}
+
+// 새 스냅샷을 만들어 게시한다. 실패하면 현재 스냅샷을 그대로 둔다 (리로드 스레드 전용)
+static void reload(ConfigReloader* reloader, long long detected_us) {
+    VMS_ConfigSnapshot_t* old = snapshot_of_node(hazard_current(&reloader->snapshots));
+    long long start_us = monotonic_us();
+    VMS_ConfigSnapshot_t* snapshot = build_snapshot(reloader, old->version + 1);
+    if (!snapshot) {
+        atomic_fetch_add_explicit(&reloader->stats.failures, 1, memory_order_relaxed);
+        fprintf(stderr, "[ConfigReloader] 다시 읽기 실패. 버전 %lu 를 계속 사용합니다.\n", old->version);
+        return;
+    }
+    long long built_us = monotonic_us();
+
+    hazard_publish(&reloader->snapshots, &snapshot->node);
+    reclaim_retired(reloader);
+
+    long long published_us = monotonic_us();
+    atomic_store_explicit(&reloader->stats.version, snapshot->version, memory_order_relaxed);
+    atomic_fetch_add_explicit(&reloader->stats.reloads, 1, memory_order_relaxed);
+    atomic_store_explicit(&reloader->stats.last_build_us, (unsigned long)(built_us - start_us), memory_order_relaxed);
+    atomic_store_explicit(&reloader->stats.last_latency_us, (unsigned long)(published_us - detected_us), memory_order_relaxed);
+    printf("[ConfigReloader] 설정 버전 %lu 게시 (읽기 %.1f ms, 변경 감지부터 %.1f ms)\n",
+           snapshot->version, (built_us - start_us) / 1000.0, (published_us - detected_us) / 1000.0);
+}
+
+static void* config_reloader_thread_func(void* arg) {
+    ConfigReloader* reloader = (ConfigReloader*)arg;
+    printf("[ConfigReloader] Watching %s, %s for changes.\n", reloader->config_path, reloader->scenario_path);
+
+    long long detected_us = 0;   // 아직 반영하지 않은 첫 변경을 감지한 시각 (없으면 0)
+    long long deadline_us = 0;   // 이 시각까지 더 바뀌지 않으면 다시 읽는다
+
+    while (atomic_load(&reloader->running)) {
+        int wait_ms = CONFIG_RELOADER_WAIT_MS;
+        if (detected_us) {
+            long long remaining_us = deadline_us - monotonic_us();
+            wait_ms = (remaining_us > 0) ? (int)((remaining_us + 999) / 1000) : 0;
+        }
+
+        struct pollfd pfd = { reloader->watch.fd, POLLIN, 0 };
+        int n = poll(&pfd, 1, wait_ms);
+        if (n < 0 && errno != EINTR) {
+            perror("[ConfigReloader] poll");
+            break;
+        }
+        if (n > 0 && file_watch_drain(&reloader->watch)) {
+            long long now_us = monotonic_us();
+            if (!detected_us) detected_us = now_us;
+            deadline_us = now_us + (long long)reloader->settle_ms * 1000;
+        }
+
+        if (detected_us && monotonic_us() >= deadline_us) {
+            reload(reloader, detected_us);
+            detected_us = 0;
+        }
+        if (reloader->snapshots.retired) reclaim_retired(reloader);
+    }
+
+    printf("[ConfigReloader] Reload thread finishing.\n");
+    return NULL;
+}
+
+ConfigReloader* config_reloader_create(const char* config_path, const char* scenario_path) {
+    if (!config_path || !scenario_path) return NULL;
+    ConfigReloader* reloader = (ConfigReloader*)calloc(1, sizeof(ConfigReloader));
+    if (!reloader) {
+        perror("Failed to allocate ConfigReloader");
+        return NULL;
+    }
+    snprintf(reloader->config_path, sizeof(reloader->config_path), "%s", config_path);
+    snprintf(reloader->scenario_path, sizeof(reloader->scenario_path), "%s", scenario_path);
+    reloader->watch.fd = -1;
+    reloader->settle_ms = CONFIG_RELOAD_SETTLE_DEFAULT_MS;
+    atomic_init(&reloader->running, false);
+    for (int i = 0; i < CONFIG_RELOADER_MAX_READERS; ++i) {
+        reloader->readers[i].hazard = NULL;
+        atomic_init(&reloader->readers[i].version_in_use, 0);
+    }
+
+    VMS_ConfigSnapshot_t* snapshot = build_snapshot(reloader, 1);
+    if (!snapshot) {
+        free(reloader);
+        return NULL;
+    }
+    hazard_domain_init(&reloader->snapshots, &snapshot->node);
+    atomic_store(&reloader->stats.version, snapshot->version);
+    return reloader;
+}
+
+bool config_reloader_start(ConfigReloader* reloader, int settle_ms) {
+    if (!reloader) return false;
+    if (settle_ms >= 0) reloader->settle_ms = settle_ms;
+    const char* paths[2] = { reloader->config_path, reloader->scenario_path };
+    if (!file_watch_open(&reloader->watch, paths, 2)) return false;
+    atomic_store(&reloader->running, true);
+    if (pthread_create(&reloader->thread, NULL, config_reloader_thread_func, reloader) != 0) {
+        perror("[ConfigReloader] 리로드 스레드 생성 실패");
+        atomic_store(&reloader->running, false);
+        file_watch_close(&reloader->watch);
+        return false;
+    }
+    reloader->thread_started = true;
+    return true;
+}
+
+void config_reloader_destroy(ConfigReloader* reloader) {
+    if (!reloader) return;
+    atomic_store(&reloader->running, false);
+    if (reloader->thread_started) pthread_join(reloader->thread, NULL);
+    file_watch_close(&reloader->watch);
+    hazard_domain_destroy(&reloader->snapshots, free_snapshot_node);
+    free(reloader);
+}
+
+const VMS_ConfigSnapshot_t* config_reloader_initial(const ConfigReloader* reloader) {
+    return snapshot_of_node(hazard_current(&((ConfigReloader*)reloader)->snapshots));
+}
+
+ConfigReader* config_reloader_register_reader(ConfigReloader* reloader) {
+    if (!reloader) return NULL;
+    HazardReader* hazard = hazard_register_reader(&reloader->snapshots);
+    if (hazard) {
+        ConfigReader* reader = &reloader->readers[hazard - reloader->snapshots.readers];
+        reader->hazard = hazard;
+        return reader;
+    }
+    fprintf(stderr, "[ConfigReloader] 읽는 스레드는 최대 %d개까지 등록할 수 있습니다.\n", CONFIG_RELOADER_MAX_READERS);
+    return NULL;
+}
+
+const VMS_ConfigSnapshot_t* config_reader_enter(ConfigReloader* reloader, ConfigReader* reader) {
+    VMS_ConfigSnapshot_t* snapshot = snapshot_of_node(hazard_enter(&reloader->snapshots, reader->hazard));
+    atomic_store_explicit(&reader->version_in_use, snapshot->version, memory_order_relaxed);
+    return snapshot;
+}
+
+void config_reader_leave(ConfigReader* reader) {
+    hazard_leave(reader->hazard);
+}
+
+void config_reloader_report(ConfigReloader* reloader, int interval_ms) {
+    if (!reloader) return;
+
+    long long now_ms = monotonic_us() / 1000;
+    long long elapsed_ms = now_ms - reloader->last_report_ms;
+    if (elapsed_ms < interval_ms || elapsed_ms <= 0) return;
+    reloader->last_report_ms = now_ms;
+
+    unsigned long in_use = 0;
+    for (int i = 0; i < CONFIG_RELOADER_MAX_READERS; ++i) {
+        if (!atomic_load(&reloader->snapshots.readers[i].registered)) continue;
+        unsigned long v = atomic_load_explicit(&reloader->readers[i].version_in_use, memory_order_relaxed);
+        if (in_use == 0 || v < in_use) in_use = v;
+    }
+    const ConfigReloaderStats* s = &reloader->stats;
+    printf("[ConfigReloader] version=%lu in_use=%lu reloads=%lu failures=%lu last_build=%.1fms last_latency=%.1fms retired_pending=%lu\n",
+           atomic_load_explicit(&s->version, memory_order_relaxed), in_use,
+           atomic_load_explicit(&s->reloads, memory_order_relaxed),
+           atomic_load_explicit(&s->failures, memory_order_relaxed),
+           atomic_load_explicit(&s->last_build_us, memory_order_relaxed) / 1000.0,
+           atomic_load_explicit(&s->last_latency_us, memory_order_relaxed) / 1000.0,
+           atomic_load_explicit(&s->retired_pending, memory_order_relaxed));
+}
@@ -0,0 +1,106 @@
+// config_reloader.h
+
+#ifndef CONFIG_RELOADER_H
+#define CONFIG_RELOADER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "VMScontroller.h"
+#include "scenario_manager.h"
+#include "hot_reload.h"
+
+#define CONFIG_RELOADER_MAX_READERS HAZARD_MAX_READERS // 스냅샷을 읽는 스레드 최대 수
+#define CONFIG_RELOAD_SETTLE_DEFAULT_MS 200 // 마지막 파일 변경 후 다시 읽기까지 기다리는 시간
+
+// config.ini와 시나리오 CSV를 한 번에 읽어 만든 설정 스냅샷. 게시된 뒤에는 읽기 전용이다.
+typedef struct VMS_ConfigSnapshot {
+    VMS_TextParamConfig_t config;
+    VMS_ScenarioList_t* scenario_list;
+    unsigned long version;                 // 1부터 다시 읽을 때마다 1씩 증가
+    HazardNode node;                       // 게시/해제 대기 목록 노드
+} VMS_ConfigSnapshot_t;
+
+// 스냅샷을 읽는 스레드 하나의 상태
+typedef struct {
+    HazardReader* hazard;                  // 읽는 동안 스냅샷을 걸어 두는 hazard pointer
+    atomic_ulong version_in_use;           // 마지막으로 사용한 스냅샷 버전 (보고용)
+} ConfigReader;
+
+// 리로드 통계 (리로드 스레드가 쓰고 어느 스레드나 읽음)
+typedef struct {
+    atomic_ulong version;          // 게시된 스냅샷 버전
+    atomic_ulong reloads;          // 게시한 새 스냅샷 수
+    atomic_ulong failures;         // 파일을 읽지 못해 이전 스냅샷을 유지한 횟수
+    atomic_ulong last_build_us;    // 마지막 스냅샷을 만드는 데 걸린 시간
+    atomic_ulong last_latency_us;  // 마지막 파일 변경 감지부터 게시까지 걸린 시간 (대기 시간 포함)
+    atomic_ulong retired_pending;  // 아직 읽는 스레드가 있어 해제하지 못한 스냅샷 수
+} ConfigReloaderStats;
+
+// config.ini와 시나리오 CSV 핫 리로드 (RCU 방식)
+// 파일이 있는 디렉터리를 inotify로 지켜보다가 변경되면 리로드 스레드에서 새 스냅샷을 만들고
+// 포인터 하나를 원자적으로 바꿔 게시한다. 읽는 쪽은 잠금 없이 config_reader_enter/leave만 호출하고
+// 항상 완성된 스냅샷 하나만 본다. 교체된 스냅샷은 읽는 스레드가 모두 놓은 뒤에 해제한다.
+// 리스닝 주소, 큐 크기, 파이프라인 같은 시작할 때만 쓰는 값은 다시 읽어도 재시작 전까지 반영되지 않는다.
+typedef struct {
+    char config_path[256];
+    char scenario_path[256];
+    HazardDomain snapshots;                // 게시된 스냅샷과 해제 대기 목록
+    ConfigReader readers[CONFIG_RELOADER_MAX_READERS]; // snapshots.readers와 같은 순서
+    ConfigReloaderStats stats;
+    int settle_ms;
+    FileWatch watch;
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool running;
+    long long last_report_ms;
+} ConfigReloader;
+
+/**
+ * @brief 설정과 시나리오를 읽어 첫 스냅샷(버전 1)을 게시합니다.
+ * @param config_path config.ini 경로.
+ * @param scenario_path 시나리오 CSV 경로.
+ * @return 성공 시 ConfigReloader 포인터 (config_reloader_destroy로 해제), 어느 하나라도 읽지 못하면 NULL.
+ */
+ConfigReloader* config_reloader_create(const char* config_path, const char* scenario_path);
+
+/**
+ * @brief 두 파일을 지켜보는 리로드 스레드를 시작합니다.
+ * @param settle_ms 마지막 변경 후 이 시간 동안 더 바뀌지 않으면 다시 읽음 (편집기가 여러 번 나눠 쓰는 경우 대비).
+ * @return 성공 시 true.
+ */
+bool config_reloader_start(ConfigReloader* reloader, int settle_ms);
+
+/**
+ * @brief 리로드 스레드를 멈추고 모든 스냅샷을 해제합니다. 읽는 스레드가 모두 끝난 뒤에 호출합니다.
+ */
+void config_reloader_destroy(ConfigReloader* reloader);
+
+/**
+ * @brief 현재 스냅샷을 반환합니다. 시작할 때만 쓰는 값을 읽기 위한 것으로, 리로드 스레드 시작 전에만 사용합니다.
+ */
+const VMS_ConfigSnapshot_t* config_reloader_initial(const ConfigReloader* reloader);
+
+/**
+ * @brief 스냅샷을 읽을 스레드를 등록합니다.
+ * @return ConfigReader 포인터. 자리가 없으면 NULL.
+ */
+ConfigReader* config_reloader_register_reader(ConfigReloader* reloader);
+
+/**
+ * @brief 현재 스냅샷을 잡습니다. config_reader_leave를 호출할 때까지 해제되지 않습니다. (잠금 없음)
+ */
+const VMS_ConfigSnapshot_t* config_reader_enter(ConfigReloader* reloader, ConfigReader* reader);
+
+/**
+ * @brief config_reader_enter로 잡은 스냅샷을 놓습니다. 이후 그 스냅샷 포인터는 사용하면 안 됩니다.
+ */
+void config_reader_leave(ConfigReader* reader);
+
+/**
+ * @brief 현재 버전, 읽는 스레드가 사용 중인 버전, 리로드 횟수와 지연 시간을 출력합니다.
+ * @param interval_ms 이 시간 이상 지났을 때만 출력 (0이면 항상 출력).
+ */
+void config_reloader_report(ConfigReloader* reloader, int interval_ms);
+
+#endif // CONFIG_RELOADER_H
@@ -0,0 +1,197 @@
+// frame_assembler.c
+
+#include "frame_assembler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>     // for sysconf, ftruncate, close
+#include <sys/mman.h>   // for memfd_create, mmap
+#include <sys/socket.h> // for recv
+
+// 링 버퍼 크기를 페이지 크기 이상의 2의 거듭제곱으로 올림
+static size_t round_up_capacity(size_t min_capacity) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t capacity = (page_size > 0) ? (size_t)page_size : 4096;
+    while (capacity < min_capacity) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// 같은 memfd를 연속된 두 가상 주소 영역에 매핑하여 미러 링 버퍼를 만든다.
+// base[i] 와 base[i + capacity] 는 같은 물리 바이트를 가리킨다.
+static char* map_mirrored_ring(size_t capacity) {
+    int fd = memfd_create("frame_ring", 0);
+    if (fd < 0) {
+        perror("[FrameAssembler] memfd_create failed");
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t)capacity) != 0) {
+        perror("[FrameAssembler] ftruncate failed");
+        close(fd);
+        return NULL;
+    }
+
+    // 2배 크기의 가상 주소 영역을 먼저 예약
+    char* base = (char*)mmap(NULL, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        perror("[FrameAssembler] mmap reserve failed");
+        close(fd);
+        return NULL;
+    }
+
+    // 예약한 영역의 앞/뒤 절반에 같은 파일을 덮어 매핑
+    if (mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        perror("[FrameAssembler] mmap mirror failed");
+        munmap(base, capacity * 2);
+        close(fd);
+        return NULL;
+    }
+
+    close(fd); // 매핑이 파일을 유지하므로 디스크립터는 닫아도 됨
+    return base;
+}
+
+FrameAssembler* frame_assembler_create(size_t min_capacity, char delimiter) {
+    FrameAssembler* fa = (FrameAssembler*)calloc(1, sizeof(FrameAssembler));
+    if (!fa) {
+        perror("Failed to allocate FrameAssembler");
+        return NULL;
+    }
+
+    fa->capacity = round_up_capacity(min_capacity);
+    fa->mask = fa->capacity - 1;
+    fa->delimiter = delimiter;
+    fa->base = map_mirrored_ring(fa->capacity);
+    if (!fa->base) {
+        free(fa);
+        return NULL;
+    }
+    return fa;
+}
+
+void frame_assembler_destroy(FrameAssembler* fa) {
+    if (!fa) return;
+    if (fa->base) {
+        munmap(fa->base, fa->capacity * 2);
+    }
+    free(fa);
+}
+
+// head에서 시작하는 프레임의 구분자를 찾아 ready 상태로 만든다.
+// 새로 도착한 바이트([scan, tail))만 탐색하며, 폐기 중인 프레임은 여기서 건너뛴다.
+static bool find_frame_end(FrameAssembler* fa) {
+    if (fa->ready) return true;
+
+    while (fa->scan < fa->tail) {
+        char* scan_ptr = fa->base + (fa->scan & fa->mask);
+        char* hit = (char*)memchr(scan_ptr, fa->delimiter, fa->tail - fa->scan);
+        if (hit == NULL) {
+            // 아직 완전한 프레임이 도착하지 않음. 다음에는 새로 들어온 바이트부터 탐색
+            fa->scan = fa->tail;
+            if (fa->discarding) {
+                fa->head = fa->tail; // 폐기 중인 프레임의 바이트는 즉시 반환
+            }
+            return false;
+        }
+
+        size_t delimiter_pos = fa->scan + (size_t)(hit - scan_ptr);
+        fa->scan = delimiter_pos + 1;
+
+        if (fa->discarding) {
+            // 잘려 나간 프레임의 끝. 다음 프레임부터 정상 처리
+            fa->discarding = false;
+            fa->head = fa->scan;
+            continue;
+        }
+
+        fa->ready = true;
+        fa->ready_delim = delimiter_pos;
+        return true;
+    }
+    return false;
+}
+
+ssize_t frame_assembler_recv(FrameAssembler* fa, int fd, size_t max_bytes) {
+    if (!fa) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    size_t free_space = fa->capacity - (fa->tail - fa->head);
+    if (free_space == 0) {
+        if (find_frame_end(fa)) {
+            // 꺼내지 않은 완성 프레임이 버퍼를 채우고 있음. 호출자가 먼저 소비해야 함
+            errno = ENOBUFS;
+            return -1;
+        }
+        // 버퍼 전체가 구분자 없는 하나의 프레임으로 찼음. 다음 구분자까지 폐기
+        fprintf(stderr, "[FrameAssembler] Receive buffer overflow! Discarding oversized frame (%zu bytes).\n",
+                fa->tail - fa->head);
+        fa->overflow_count++;
+        fa->discarding = true;
+        fa->head = fa->tail;
+        fa->scan = fa->tail;
+        free_space = fa->capacity;
+    }
+    if (max_bytes > 0 && max_bytes < free_space) {
+        free_space = max_bytes;
+    }
+
+    // 미러 매핑 덕분에 빈 공간은 링의 끝을 넘어가더라도 항상 연속적이다
+    ssize_t bytes_read = recv(fd, fa->base + (fa->tail & fa->mask), free_space, 0);
+    if (bytes_read > 0) {
+        fa->tail += (size_t)bytes_read;
+    }
+    return bytes_read;
+}
+
+bool frame_assembler_next(FrameAssembler* fa, char** out_frame, size_t* out_len) {
+    if (!fa || !out_frame || !out_len) return false;
+    if (!find_frame_end(fa)) return false;
+
+    fa->base[fa->ready_delim & fa->mask] = '\0'; // 구분자를 널 문자로 바꿔 버퍼 안에서 바로 C 문자열로 사용
+    *out_frame = fa->base + (fa->head & fa->mask);
+    *out_len = fa->ready_delim - fa->head;
+    fa->head = fa->ready_delim + 1;
+    fa->ready = false;
+    return true;
+}
+
+bool frame_assembler_has_frame(FrameAssembler* fa) {
+    return fa ? find_frame_end(fa) : false;
+}
+
+int frame_assembler_skip_to_latest(FrameAssembler* fa) {
+    if (!fa || !find_frame_end(fa)) return 0;
+
+    int skipped = 0;
+    while (fa->scan < fa->tail) {
+        char* scan_ptr = fa->base + (fa->scan & fa->mask);
+        char* hit = (char*)memchr(scan_ptr, fa->delimiter, fa->tail - fa->scan);
+        if (hit == NULL) {
+            fa->scan = fa->tail;
+            break;
+        }
+        // 더 새로운 완성 프레임이 있으므로 현재 프레임은 버림
+        fa->head = fa->ready_delim + 1;
+        fa->ready_delim = fa->scan + (size_t)(hit - scan_ptr);
+        fa->scan = fa->ready_delim + 1;
+        skipped++;
+    }
+    return skipped;
+}
+
+void frame_assembler_reset(FrameAssembler* fa) {
+    if (!fa) return;
+    fa->head = fa->tail;
+    fa->scan = fa->tail;
+    fa->ready = false;
+    fa->discarding = false;
+}
+
+size_t frame_assembler_pending_bytes(const FrameAssembler* fa) {
+    return fa ? fa->tail - fa->head : 0;
+}
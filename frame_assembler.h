@@ -0,0 +1,86 @@
+// frame_assembler.h
+
+#ifndef FRAME_ASSEMBLER_H
+#define FRAME_ASSEMBLER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h> // for ssize_t
+
+#define FRAME_DELIMITER '!' // SDSM JSON 프레임 구분 문자
+
+// 수신 스트림을 구분자 단위 프레임으로 조립하는 링 버퍼
+// 같은 물리 페이지를 가상 주소 공간에 두 번 연속 매핑(미러 매핑)하므로
+// 링의 끝을 넘어가는 영역도 항상 연속된 메모리로 접근할 수 있다.
+typedef struct {
+    char* base;             // 미러 매핑된 링 버퍼 시작 주소 (capacity * 2 바이트 가상 영역)
+    size_t capacity;        // 링 버퍼 크기 (2의 거듭제곱, 페이지 크기 이상)
+    size_t mask;            // capacity - 1
+    size_t head;            // 다음 프레임이 시작되는 위치 (단조 증가 인덱스)
+    size_t tail;            // 수신된 데이터의 끝 위치 (단조 증가 인덱스)
+    size_t scan;            // 구분자 탐색을 마친 위치. 새로 도착한 바이트만 탐색하기 위함
+    bool ready;             // head에서 시작하는 프레임의 구분자를 이미 찾았으면 true
+    size_t ready_delim;     // ready일 때 그 프레임의 구분자 위치
+    bool discarding;        // 버퍼보다 큰 프레임을 버리는 중이면 true (다음 구분자까지 폐기)
+    char delimiter;         // 프레임 구분 문자
+    unsigned long overflow_count; // 버퍼 크기를 넘어 폐기된 프레임 수
+} FrameAssembler;
+
+/**
+ * @brief 프레임 조립기를 생성합니다.
+ * @param min_capacity 최소 버퍼 크기(바이트). 페이지 크기 이상의 2의 거듭제곱으로 올림됩니다.
+ * @param delimiter 프레임 구분 문자 (예: FRAME_DELIMITER).
+ * @return 성공 시 FrameAssembler 포인터 (frame_assembler_destroy로 해제), 실패 시 NULL.
+ */
+FrameAssembler* frame_assembler_create(size_t min_capacity, char delimiter);
+
+/**
+ * @brief 프레임 조립기와 매핑된 메모리를 해제합니다.
+ */
+void frame_assembler_destroy(FrameAssembler* fa);
+
+/**
+ * @brief 소켓에서 링 버퍼의 빈 공간으로 직접 recv 합니다. (중간 복사 없음)
+ * @param fa 프레임 조립기.
+ * @param fd 읽을 소켓 디스크립터.
+ * @param max_bytes 이번 호출에서 읽을 최대 바이트 수. 0이면 빈 공간 전체.
+ * @return 수신한 바이트 수, 상대가 연결을 끊으면 0, 오류 시 -1 (errno 유지).
+ * 빈 공간이 없을 때 아직 꺼내지 않은 완성 프레임이 있으면 -1 (errno = ENOBUFS)을 반환하고,
+ * 완성 프레임 없이 가득 찼으면 그 프레임을 폐기하고 공간을 확보한 뒤 수신합니다.
+ */
+ssize_t frame_assembler_recv(FrameAssembler* fa, int fd, size_t max_bytes);
+
+/**
+ * @brief 다음 완성된 프레임을 꺼냅니다.
+ * 구분자는 버퍼 안에서 '\0'으로 바뀌므로 반환된 포인터는 그대로 C 문자열로 사용할 수 있습니다.
+ * @param fa 프레임 조립기.
+ * @param out_frame 프레임 시작 포인터 (링 버퍼 내부를 가리킴, 복사본 아님).
+ * @param out_len 구분자를 제외한 프레임 길이.
+ * @return 완성된 프레임이 있으면 true.
+ * 반환된 포인터는 다음 frame_assembler_recv / frame_assembler_reset 호출 전까지만 유효합니다.
+ */
+bool frame_assembler_next(FrameAssembler* fa, char** out_frame, size_t* out_len);
+
+/**
+ * @brief 꺼낼 수 있는 완성된 프레임이 있는지 확인합니다. (프레임을 꺼내지는 않음)
+ */
+bool frame_assembler_has_frame(FrameAssembler* fa);
+
+/**
+ * @brief 완성된 프레임 중 가장 최근 것 하나만 남기고 나머지는 꺼내지 않고 버립니다.
+ * 남은 프레임은 꺼내기 전까지 버퍼에 유지되므로 이후 recv 호출에도 안전합니다.
+ * @return 버린 프레임 수.
+ */
+int frame_assembler_skip_to_latest(FrameAssembler* fa);
+
+/**
+ * @brief 버퍼에 남은 데이터를 모두 버립니다. (연결 종료 시 사용)
+ */
+void frame_assembler_reset(FrameAssembler* fa);
+
+/**
+ * @brief 현재 버퍼에 쌓여 있는(아직 꺼내지 않은) 바이트 수를 반환합니다.
+ */
+size_t frame_assembler_pending_bytes(const FrameAssembler* fa);
+
+#endif // FRAME_ASSEMBLER_H
@@ -0,0 +1,143 @@
+// hot_reload.c
+
+#include "hot_reload.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+void hazard_domain_init(HazardDomain* domain, HazardNode* initial) {
+    atomic_init(&domain->current, initial);
+    for (int i = 0; i < HAZARD_MAX_READERS; ++i) {
+        atomic_init(&domain->readers[i].hazard, NULL);
+        atomic_init(&domain->readers[i].registered, false);
+    }
+    domain->retired = NULL;
+}
+
+void hazard_domain_destroy(HazardDomain* domain, HazardFreeFn free_fn) {
+    while (domain->retired) {
+        HazardNode* next = domain->retired->next_retired;
+        free_fn(domain->retired);
+        domain->retired = next;
+    }
+    HazardNode* current = atomic_load(&domain->current);
+    atomic_store(&domain->current, NULL);
+    if (current) free_fn(current);
+}
+
+HazardNode* hazard_current(HazardDomain* domain) {
+    return atomic_load(&domain->current);
+}
+
+HazardNode* hazard_publish(HazardDomain* domain, HazardNode* next) {
+    // 포인터 하나만 바꾸므로 읽는 쪽은 이전 또는 새 객체 중 하나를 온전히 본다
+    HazardNode* old = atomic_exchange(&domain->current, next);
+    old->next_retired = domain->retired;
+    domain->retired = old;
+    return old;
+}
+
+unsigned long hazard_reclaim(HazardDomain* domain, HazardFreeFn free_fn) {
+    HazardNode** link = &domain->retired;
+    unsigned long pending = 0;
+    while (*link) {
+        HazardNode* node = *link;
+        bool in_use = false;
+        for (int i = 0; i < HAZARD_MAX_READERS; ++i) {
+            if (atomic_load(&domain->readers[i].hazard) == node) {
+                in_use = true;
+                break;
+            }
+        }
+        if (in_use) {
+            link = &node->next_retired;
+            pending++;
+        } else {
+            *link = node->next_retired;
+            free_fn(node);
+        }
+    }
+    return pending;
+}
+
+HazardReader* hazard_register_reader(HazardDomain* domain) {
+    for (int i = 0; i < HAZARD_MAX_READERS; ++i) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&domain->readers[i].registered, &expected, true)) {
+            return &domain->readers[i];
+        }
+    }
+    return NULL;
+}
+
+HazardNode* hazard_enter(HazardDomain* domain, HazardReader* reader) {
+    HazardNode* node;
+    // hazard를 건 뒤에도 같은 객체가 게시되어 있으면, 게시하는 스레드가 교체했더라도 hazard를 보고 해제하지 않는다
+    do {
+        node = atomic_load(&domain->current);
+        atomic_store(&reader->hazard, node);
+    } while (atomic_load(&domain->current) != node);
+    return node;
+}
+
+void hazard_leave(HazardReader* reader) {
+    atomic_store_explicit(&reader->hazard, NULL, memory_order_release);
+}
+
+// path를 디렉터리와 파일 이름으로 나눈다 (디렉터리가 없으면 ".")
+static const char* split_path(const char* path, char* dir, size_t dir_size) {
+    const char* slash = strrchr(path, '/');
+    if (!slash) {
+        snprintf(dir, dir_size, ".");
+        return path;
+    }
+    snprintf(dir, dir_size, "%.*s", (int)(slash - path > 0 ? slash - path : 1), path);
+    return slash + 1;
+}
+
+bool file_watch_open(FileWatch* watch, const char* const* paths, int num_paths) {
+    memset(watch, 0, sizeof(*watch));
+    watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->fd < 0) {
+        perror("[FileWatch] inotify_init1");
+        return false;
+    }
+    if (num_paths > FILE_WATCH_MAX_FILES) num_paths = FILE_WATCH_MAX_FILES;
+    for (int i = 0; i < num_paths; ++i) {
+        char dir[256];
+        watch->names[i] = split_path(paths[i], dir, sizeof(dir));
+        watch->watches[i] = inotify_add_watch(watch->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch->watches[i] < 0) {
+            fprintf(stderr, "[FileWatch] inotify_add_watch(%s) 실패: %s\n", dir, strerror(errno));
+        }
+    }
+    watch->num_files = num_paths;
+    return true;
+}
+
+bool file_watch_drain(FileWatch* watch) {
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t len;
+    while ((len = read(watch->fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + len;) {
+            const struct inotify_event* ev = (const struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + ev->len;
+            if (ev->len == 0) continue;
+            for (int i = 0; i < watch->num_files; ++i) {
+                if (ev->wd == watch->watches[i] && strcmp(ev->name, watch->names[i]) == 0) {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+void file_watch_close(FileWatch* watch) {
+    if (watch->fd >= 0) close(watch->fd);
+    watch->fd = -1;
+}
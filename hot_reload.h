@@ -0,0 +1,102 @@
+// hot_reload.h
+
+#ifndef HOT_RELOAD_H
+#define HOT_RELOAD_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define HAZARD_MAX_READERS 4      // 게시된 객체를 읽는 스레드 최대 수
+#define FILE_WATCH_MAX_FILES 2
+
+// 게시되는 객체에 포함시키는 노드. 해제 함수에서 offsetof로 원래 구조체를 찾는다.
+typedef struct HazardNode {
+    struct HazardNode* next_retired; // 해제 대기 목록 (게시하는 스레드 전용)
+} HazardNode;
+
+// 게시된 객체를 읽는 스레드 하나의 hazard pointer
+// 읽는 동안 hazard에 객체를 걸어 두면 게시하는 스레드가 그 객체를 해제하지 않는다.
+typedef struct {
+    _Atomic(HazardNode*) hazard;
+    atomic_bool registered;
+} HazardReader;
+
+// 읽기 전용 객체 하나를 게시하고 교체하는 RCU 방식 도메인
+// 게시하는 스레드는 하나이고, 읽는 쪽은 잠금 없이 hazard_enter/leave만 호출한다.
+// 교체된 객체는 읽는 스레드가 모두 놓은 뒤 hazard_reclaim에서 해제한다.
+typedef struct {
+    _Atomic(HazardNode*) current;
+    HazardReader readers[HAZARD_MAX_READERS];
+    HazardNode* retired;                   // 해제 대기 목록 (게시하는 스레드 전용)
+} HazardDomain;
+
+typedef void (*HazardFreeFn)(HazardNode* node);
+
+/**
+ * @brief 도메인을 초기화하고 첫 객체를 게시합니다.
+ */
+void hazard_domain_init(HazardDomain* domain, HazardNode* initial);
+
+/**
+ * @brief 게시된 객체와 해제 대기 중인 객체를 모두 해제합니다. 읽는 스레드가 모두 끝난 뒤에 호출합니다.
+ */
+void hazard_domain_destroy(HazardDomain* domain, HazardFreeFn free_fn);
+
+/**
+ * @brief 게시된 객체를 반환합니다. 게시하는 스레드 또는 읽는 스레드가 시작되기 전에만 사용합니다.
+ */
+HazardNode* hazard_current(HazardDomain* domain);
+
+/**
+ * @brief 새 객체를 게시하고 이전 객체를 해제 대기 목록에 넣습니다. (게시하는 스레드 전용)
+ * @return 이전 객체.
+ */
+HazardNode* hazard_publish(HazardDomain* domain, HazardNode* next);
+
+/**
+ * @brief 읽는 스레드가 hazard에 걸어 두지 않은 해제 대기 객체를 해제합니다. (게시하는 스레드 전용)
+ * @return 아직 사용 중이라 남겨 둔 객체 수.
+ */
+unsigned long hazard_reclaim(HazardDomain* domain, HazardFreeFn free_fn);
+
+/**
+ * @brief 객체를 읽을 스레드를 등록합니다.
+ * @return HazardReader 포인터. 자리가 없으면 NULL.
+ */
+HazardReader* hazard_register_reader(HazardDomain* domain);
+
+/**
+ * @brief 게시된 객체를 잡습니다. hazard_leave를 호출할 때까지 해제되지 않습니다. (잠금 없음)
+ */
+HazardNode* hazard_enter(HazardDomain* domain, HazardReader* reader);
+
+/**
+ * @brief hazard_enter로 잡은 객체를 놓습니다. 이후 그 객체 포인터는 사용하면 안 됩니다.
+ */
+void hazard_leave(HazardReader* reader);
+
+// 설정 파일 변경 감지 (inotify)
+// 편집기는 보통 새 파일을 쓰고 이름을 바꾸므로 파일이 아니라 파일이 있는 디렉터리를 지켜본다.
+typedef struct {
+    int fd;                                   // inotify (논블로킹). poll/epoll에 등록해 사용
+    int num_files;
+    int watches[FILE_WATCH_MAX_FILES];
+    const char* names[FILE_WATCH_MAX_FILES];  // 디렉터리 안의 파일 이름 (paths 문자열을 가리킴)
+} FileWatch;
+
+/**
+ * @brief 파일들이 있는 디렉터리를 감시합니다. 디렉터리 감시에 실패한 파일은 로그만 남기고 건너뜁니다.
+ * @param paths 감시할 파일 경로들. FileWatch를 닫을 때까지 유지되어야 합니다.
+ * @return inotify를 만들지 못하면 false.
+ */
+bool file_watch_open(FileWatch* watch, const char* const* paths, int num_paths);
+
+/**
+ * @brief 쌓인 inotify 이벤트를 모두 읽습니다.
+ * @return 감시하는 파일 중 하나라도 바뀌었으면 true.
+ */
+bool file_watch_drain(FileWatch* watch);
+
+void file_watch_close(FileWatch* watch);
+
+#endif // HOT_RELOAD_H
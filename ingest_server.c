@@ -0,0 +1,340 @@
+// ingest_server.c
+
+#include "ingest_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>    // for strcasecmp
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>     // for close()
+#include <fcntl.h>      // for fcntl, O_NONBLOCK
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define INGEST_MAX_EVENTS 64
+
+static long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void close_connection(IngestServer* server, int slot) {
+    IngestConnection* conn = server->conns[slot];
+    if (!conn) return;
+
+    printf("[Ingest] Connection #%d (%s, fd: %d) closed. bytes=%lu processed=%lu coalesced=%lu dropped=%lu\n",
+           conn->conn_id, conn->peer, conn->fd, conn->bytes_received,
+           conn->counters.processed, conn->counters.coalesced, conn->counters.dropped);
+    if (conn->backlog) server->num_backlogged--;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    frame_assembler_destroy(conn->assembler);
+    free(conn);
+    server->conns[slot] = NULL;
+    server->num_connections--;
+}
+
+// 리스닝 소켓에 대기 중인 연결을 모두 수락
+static void accept_connections(IngestServer* server) {
+    while (1) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int new_socket = accept4(server->listen_fd, (struct sockaddr*)&client_addr, &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (new_socket < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("[Ingest] accept failed");
+            }
+            return;
+        }
+
+        int slot = -1;
+        for (int i = 0; i < server->max_connections; ++i) {
+            if (server->conns[i] == NULL) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) {
+            fprintf(stderr, "[Ingest] Connection from %s:%d rejected (max %d connections).\n",
+                    inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port), server->max_connections);
+            server->rejected_connections++;
+            close(new_socket);
+            continue;
+        }
+
+        IngestConnection* conn = (IngestConnection*)calloc(1, sizeof(IngestConnection));
+        if (!conn) {
+            perror("[Ingest] Failed to allocate IngestConnection");
+            close(new_socket);
+            continue;
+        }
+        conn->fd = new_socket;
+        conn->conn_id = ++server->next_conn_id;
+        snprintf(conn->peer, sizeof(conn->peer), "%s:%d", inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port));
+        conn->assembler = frame_assembler_create(server->recv_buffer_size, FRAME_DELIMITER);
+        if (!conn->assembler) {
+            close(new_socket);
+            free(conn);
+            continue;
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = conn;
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, new_socket, &ev) < 0) {
+            perror("[Ingest] epoll_ctl ADD connection failed");
+            frame_assembler_destroy(conn->assembler);
+            close(new_socket);
+            free(conn);
+            continue;
+        }
+
+        server->conns[slot] = conn;
+        server->num_connections++;
+        printf("[Ingest] New connection #%d accepted from %s (fd: %d, %d/%d connections)\n",
+               conn->conn_id, conn->peer, new_socket, server->num_connections, server->max_connections);
+    }
+}
+
+// 연결에 남은 완성 프레임을 정책에 따라 처리
+// INGEST_DRAIN_MAX에서 한도에 걸려 프레임이 남으면 false 반환 (더 읽지 않고 다음 poll로 넘김)
+static bool drain_frames(IngestServer* server, IngestConnection* conn, int* frames_this_wakeup,
+                         IngestFrameHandler handler, void* user_data) {
+    char* frame;
+    size_t frame_len;
+
+    if (server->drain_policy == INGEST_DRAIN_LATEST) {
+        // 가장 최근 프레임만 남겨두고, 실제 처리는 이번 wakeup의 수신이 끝난 뒤에 한다
+        int skipped = frame_assembler_skip_to_latest(conn->assembler);
+        conn->counters.coalesced += (unsigned long)skipped;
+        server->totals.coalesced += (unsigned long)skipped;
+        return true;
+    }
+
+    while (server->drain_policy == INGEST_DRAIN_ALL || *frames_this_wakeup < server->drain_max_frames) {
+        if (!frame_assembler_next(conn->assembler, &frame, &frame_len)) return true;
+        (*frames_this_wakeup)++;
+        conn->counters.processed++;
+        server->totals.processed++;
+        if (handler) handler(frame, frame_len, conn, user_data);
+    }
+    return !frame_assembler_has_frame(conn->assembler);
+}
+
+static void set_backlog(IngestServer* server, IngestConnection* conn, bool backlog) {
+    if (conn->backlog == backlog) return;
+    conn->backlog = backlog;
+    server->num_backlogged += backlog ? 1 : -1;
+}
+
+// 한 연결에서 read_budget 만큼 수신하고 완성된 프레임을 정책에 따라 콜백으로 전달
+// 연결을 닫아야 하면 false 반환
+static bool read_connection(IngestServer* server, IngestConnection* conn, IngestFrameHandler handler, void* user_data) {
+    size_t budget = server->read_budget;
+    int frames_this_wakeup = 0;
+    bool more_data = true;   // 소켓에 읽을 데이터가 더 있을 수 있음
+    bool peer_closed = false;
+    bool recv_failed = false;
+
+    conn->last_round = server->round;
+
+    while (1) {
+        // 프레임 포인터는 다음 recv 전까지만 유효하므로 수신 전에 먼저 처리
+        if (!drain_frames(server, conn, &frames_this_wakeup, handler, user_data)) {
+            set_backlog(server, conn, true); // 처리 한도 도달. 수신은 남은 프레임을 소진한 뒤에
+            return true;
+        }
+        if (!more_data || budget == 0) break;
+
+        ssize_t bytes_read = frame_assembler_recv(conn->assembler, conn->fd, budget);
+        unsigned long overflows = conn->assembler->overflow_count;
+        if (overflows != conn->counters.dropped) {
+            server->totals.dropped += overflows - conn->counters.dropped;
+            conn->counters.dropped = overflows;
+        }
+
+        if (bytes_read < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+                fprintf(stderr, "[Ingest] recv error on connection #%d (%s): %s\n", conn->conn_id, conn->peer, strerror(errno));
+                recv_failed = true;
+            }
+            more_data = false; // 읽을 데이터 소진 또는 버퍼가 완성 프레임으로 가득 참
+            continue;
+        }
+        if (bytes_read == 0) {
+            peer_closed = true; // 상대가 연결 종료. 이미 받은 완성 프레임은 처리하고 닫음
+            more_data = false;
+            continue;
+        }
+        conn->bytes_received += (unsigned long)bytes_read;
+        budget -= ((size_t)bytes_read < budget) ? (size_t)bytes_read : budget;
+    }
+
+    if (server->drain_policy == INGEST_DRAIN_LATEST) {
+        char* frame;
+        size_t frame_len;
+        if (frame_assembler_next(conn->assembler, &frame, &frame_len)) {
+            conn->counters.processed++;
+            server->totals.processed++;
+            if (handler) handler(frame, frame_len, conn, user_data);
+        }
+    }
+
+    set_backlog(server, conn, false);
+    return !(peer_closed || recv_failed); // 예산이 남은 데이터는 다음 poll에서 (level-triggered)
+}
+
+static void close_connection_ptr(IngestServer* server, IngestConnection* conn) {
+    for (int slot = 0; slot < server->max_connections; ++slot) {
+        if (server->conns[slot] == conn) {
+            close_connection(server, slot);
+            return;
+        }
+    }
+}
+
+IngestServer* ingest_server_create(int listen_fd, int max_connections, size_t read_budget, size_t recv_buffer_size,
+                                   IngestDrainPolicy drain_policy, int drain_max_frames) {
+    if (listen_fd < 0) return NULL;
+
+    IngestServer* server = (IngestServer*)calloc(1, sizeof(IngestServer));
+    if (!server) {
+        perror("Failed to allocate IngestServer");
+        return NULL;
+    }
+    server->listen_fd = listen_fd;
+    server->max_connections = (max_connections > 0) ? max_connections : INGEST_DEFAULT_MAX_CONNECTIONS;
+    server->read_budget = (read_budget > 0) ? read_budget : INGEST_DEFAULT_READ_BUDGET;
+    server->recv_buffer_size = recv_buffer_size;
+    server->drain_policy = drain_policy;
+    server->drain_max_frames = (drain_max_frames > 0) ? drain_max_frames : INGEST_DEFAULT_DRAIN_MAX_FRAMES;
+    server->last_report_ms = monotonic_ms();
+
+    server->conns = (IngestConnection**)calloc(server->max_connections, sizeof(IngestConnection*));
+    if (!server->conns) {
+        perror("Failed to allocate ingest connection slots");
+        free(server);
+        return NULL;
+    }
+
+    if (set_nonblocking(listen_fd) < 0) {
+        perror("[Ingest] Failed to set listening socket non-blocking");
+        free(server->conns);
+        free(server);
+        return NULL;
+    }
+
+    server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (server->epoll_fd < 0) {
+        perror("[Ingest] epoll_create1 failed");
+        free(server->conns);
+        free(server);
+        return NULL;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL; // NULL은 리스닝 소켓을 의미
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        perror("[Ingest] epoll_ctl ADD listen socket failed");
+        close(server->epoll_fd);
+        free(server->conns);
+        free(server);
+        return NULL;
+    }
+
+    printf("[Ingest] Ingest server ready (max connections: %d, read budget: %zu bytes, drain policy: %s",
+           server->max_connections, server->read_budget,
+           drain_policy == INGEST_DRAIN_LATEST ? "latest" : (drain_policy == INGEST_DRAIN_MAX ? "max" : "all"));
+    if (drain_policy == INGEST_DRAIN_MAX) printf(" %d", server->drain_max_frames);
+    printf(")\n");
+    return server;
+}
+
+int ingest_server_poll(IngestServer* server, int timeout_ms, IngestFrameHandler handler, void* user_data) {
+    if (!server) return -1;
+
+    // 처리하지 못한 완성 프레임이 남아 있으면 새 이벤트를 기다리지 않는다
+    struct epoll_event events[INGEST_MAX_EVENTS];
+    int n = epoll_wait(server->epoll_fd, events, INGEST_MAX_EVENTS, server->num_backlogged > 0 ? 0 : timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) return 0;
+        perror("[Ingest] epoll_wait error");
+        return -1;
+    }
+    server->round++;
+
+    for (int i = 0; i < n; ++i) {
+        IngestConnection* conn = (IngestConnection*)events[i].data.ptr;
+        if (conn == NULL) {
+            accept_connections(server);
+            continue;
+        }
+
+        bool keep_open = true;
+        if (events[i].events & EPOLLIN) {
+            keep_open = read_connection(server, conn, handler, user_data);
+        } else if (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            keep_open = false;
+        }
+
+        if (!keep_open) {
+            close_connection_ptr(server, conn);
+        }
+    }
+
+    // 이번 회차에 이벤트가 없었지만 남은 프레임이 있는 연결 처리
+    for (int slot = 0; slot < server->max_connections && server->num_backlogged > 0; ++slot) {
+        IngestConnection* conn = server->conns[slot];
+        if (conn && conn->backlog && conn->last_round != server->round) {
+            if (!read_connection(server, conn, handler, user_data)) {
+                close_connection(server, slot);
+            }
+        }
+    }
+    return n;
+}
+
+bool ingest_server_report(IngestServer* server, int interval_ms) {
+    if (!server) return false;
+    long long now_ms = monotonic_ms();
+    if (interval_ms > 0 && now_ms - server->last_report_ms < interval_ms) return false;
+    server->last_report_ms = now_ms;
+
+    printf("[Ingest] connections=%d backlogged=%d frames processed=%lu coalesced=%lu dropped=%lu rejected_connections=%lu\n",
+           server->num_connections, server->num_backlogged,
+           server->totals.processed, server->totals.coalesced, server->totals.dropped, server->rejected_connections);
+    return true;
+}
+
+IngestDrainPolicy ingest_drain_policy_from_string(const char* str) {
+    if (str) {
+        if (strcasecmp(str, "latest") == 0) return INGEST_DRAIN_LATEST;
+        if (strcasecmp(str, "max") == 0) return INGEST_DRAIN_MAX;
+    }
+    return INGEST_DRAIN_ALL;
+}
+
+void ingest_server_destroy(IngestServer* server) {
+    if (!server) return;
+    for (int slot = 0; slot < server->max_connections; ++slot) {
+        close_connection(server, slot);
+    }
+    free(server->conns);
+    if (server->epoll_fd >= 0) close(server->epoll_fd);
+    if (server->listen_fd >= 0) close(server->listen_fd);
+    free(server);
+}
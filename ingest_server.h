@@ -0,0 +1,106 @@
+// ingest_server.h
+
+#ifndef INGEST_SERVER_H
+#define INGEST_SERVER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "frame_assembler.h"
+
+#define INGEST_DEFAULT_MAX_CONNECTIONS 8
+#define INGEST_DEFAULT_READ_BUDGET (64 * 1024) // 한 번의 이벤트 처리에서 연결당 최대 수신 바이트
+#define INGEST_DEFAULT_DRAIN_MAX_FRAMES 4
+
+// 연결마다 한 번의 처리 기회(wakeup)에서 완성된 프레임을 얼마나 처리할지 정하는 정책
+typedef enum {
+    INGEST_DRAIN_ALL = 0,   // 완성된 프레임을 모두 처리
+    INGEST_DRAIN_LATEST,    // 가장 최근 프레임 하나만 처리하고 나머지는 합쳐서(coalesce) 버림
+    INGEST_DRAIN_MAX        // 최대 N개만 처리. 남은 프레임은 다음 poll에서 대기 없이 바로 이어서 처리
+} IngestDrainPolicy;
+
+// 프레임 처리 카운터
+typedef struct {
+    unsigned long processed;   // 콜백으로 전달한 프레임 수
+    unsigned long coalesced;   // 더 새로운 프레임에 밀려 처리하지 않은 프레임 수 (LATEST)
+    unsigned long dropped;     // 버퍼 크기 초과 등으로 폐기된 프레임 수
+} IngestFrameCounters;
+
+// SDSM 송신측(RSU, 인지 장치 등) 하나와의 연결 정보
+typedef struct {
+    int fd;                       // 연결 소켓 디스크립터
+    int conn_id;                  // 로그 및 콜백 구분용 연결 번호 (접속 순서대로 증가)
+    char peer[32];                // "IP:PORT"
+    FrameAssembler* assembler;    // 연결별 프레임 조립 상태
+    unsigned long bytes_received; // 누적 수신 바이트
+    IngestFrameCounters counters; // 연결별 프레임 처리 카운터
+    bool backlog;                 // 처리 한도(MAX)에 걸려 완성 프레임이 남아 있으면 true
+    unsigned long last_round;     // 마지막으로 처리된 poll 회차
+} IngestConnection;
+
+// 완성된 프레임 하나가 준비될 때마다 호출되는 콜백
+// frame은 연결의 링 버퍼 내부를 가리키며 콜백이 반환된 뒤에는 유효하지 않다.
+typedef void (*IngestFrameHandler)(char* frame, size_t frame_len, const IngestConnection* conn, void* user_data);
+
+// epoll 기반 다중 연결 수신 서버
+typedef struct {
+    int listen_fd;                // 리스닝 소켓 (ingest_server_destroy에서 닫음)
+    int epoll_fd;
+    IngestConnection** conns;     // 연결 슬롯 배열 (max_connections 개, 빈 슬롯은 NULL)
+    int max_connections;          // 동시에 허용할 최대 연결 수
+    int num_connections;          // 현재 연결 수
+    size_t read_budget;           // 한 번의 이벤트 처리에서 연결당 최대 수신 바이트
+    size_t recv_buffer_size;      // 연결별 링 버퍼 크기
+    IngestDrainPolicy drain_policy; // 프레임 처리 정책
+    int drain_max_frames;         // INGEST_DRAIN_MAX일 때 wakeup당 최대 처리 프레임 수
+    int num_backlogged;           // 처리할 프레임이 남아 있는 연결 수 (0보다 크면 poll이 대기하지 않음)
+    unsigned long round;          // poll 회차
+    int next_conn_id;
+    unsigned long rejected_connections; // 최대 연결 수 초과로 거절한 연결 수
+    IngestFrameCounters totals;   // 종료된 연결을 포함한 전체 카운터
+    long long last_report_ms;
+} IngestServer;
+
+/**
+ * @brief 이미 listen 중인 소켓으로 수신 서버를 생성합니다.
+ * @param listen_fd setup_listening_socket 등으로 만든 리스닝 소켓. 논블로킹으로 전환됩니다.
+ * @param max_connections 동시에 허용할 최대 연결 수 (0 이하이면 기본값).
+ * @param read_budget 한 번의 이벤트 처리에서 연결당 최대 수신 바이트 (0이면 기본값).
+ * @param recv_buffer_size 연결별 프레임 조립 버퍼 크기.
+ * @param drain_policy 완성된 프레임 처리 정책.
+ * @param drain_max_frames INGEST_DRAIN_MAX일 때 wakeup당 최대 처리 프레임 수 (0 이하이면 기본값).
+ * @return 성공 시 IngestServer 포인터 (ingest_server_destroy로 해제), 실패 시 NULL.
+ */
+IngestServer* ingest_server_create(int listen_fd, int max_connections, size_t read_budget, size_t recv_buffer_size,
+                                   IngestDrainPolicy drain_policy, int drain_max_frames);
+
+/**
+ * @brief 이벤트를 한 번 대기하고 새 연결 수락, 데이터 수신, 프레임 콜백 호출을 처리합니다.
+ * 각 연결은 read_budget 만큼만 읽고 다음 연결로 넘어가므로, 데이터를 많이 보내는 송신측이
+ * 다른 송신측을 굶기지 않습니다. 남은 데이터는 다음 호출에서 이어서 읽습니다.
+ * 처리 한도 때문에 남은 완성 프레임이 있으면 대기하지 않고 바로 반환해 다음 호출에서 처리합니다.
+ * @param server 수신 서버.
+ * @param timeout_ms epoll_wait 대기 시간 (밀리초). 남은 프레임이 있으면 무시하고 0으로 대기.
+ * @param handler 완성된 프레임마다 호출할 콜백.
+ * @param user_data 콜백에 그대로 전달할 사용자 데이터.
+ * @return 처리한 이벤트 수, 타임아웃이면 0, 치명적 오류 시 -1.
+ */
+int ingest_server_poll(IngestServer* server, int timeout_ms, IngestFrameHandler handler, void* user_data);
+
+/**
+ * @brief 처리/합침/폐기 프레임 카운터를 출력합니다.
+ * @param interval_ms 이 시간 이상 지났을 때만 출력 (0이면 항상 출력).
+ * @return 출력했으면 true.
+ */
+bool ingest_server_report(IngestServer* server, int interval_ms);
+
+/**
+ * @brief "all", "latest", "max" 문자열을 처리 정책으로 변환합니다. 알 수 없으면 INGEST_DRAIN_ALL.
+ */
+IngestDrainPolicy ingest_drain_policy_from_string(const char* str);
+
+/**
+ * @brief 모든 연결과 리스닝 소켓을 닫고 서버를 해제합니다.
+ */
+void ingest_server_destroy(IngestServer* server);
+
+#endif // INGEST_SERVER_H
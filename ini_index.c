@@ -0,0 +1,272 @@
+// ini_index.c
+
+#include "ini_index.h"
+#include "minIni.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    size_t name_off;  // pool 안의 섹션 이름 위치
+    int first;        // 같은 이름으로 처음 나온 섹션 번호 (조회는 항상 이 섹션 기준)
+} IniSection;
+
+typedef struct {
+    int section;      // 이 키가 나온 섹션 번호
+    size_t key_off;
+    size_t value_off;
+    uint32_t hash;
+} IniEntry;
+
+struct IniIndex {
+    char* pool;               // 섹션 이름, 키, 값 문자열 (NUL 구분). realloc되므로 위치는 오프셋으로 보관
+    size_t pool_len;
+    size_t pool_cap;
+    IniSection* sections;
+    int num_sections;
+    int sections_cap;
+    int first_named;          // 첫 섹션 앞의 키들(이름 "")이 있으면 1. 섹션 열거에서 뺀다 (ini_getsection과 같게)
+    IniEntry* entries;
+    int num_entries;
+    int entries_cap;
+    int* section_table;       // 섹션 이름 해시 테이블 (처음 나온 섹션 번호, 빈 칸은 -1)
+    size_t section_mask;
+    int* entry_table;         // (섹션, 키) 해시 테이블 (entries 인덱스, 빈 칸은 -1)
+    size_t entry_mask;
+    bool failed;              // 읽는 중 메모리 부족
+};
+
+// 대소문자 구분 없는 FNV-1a (minIni처럼 ASCII만 접는다)
+static uint32_t fold_hash(const char* s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (; *s; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c >= 'A' && c <= 'Z') c = (unsigned char)(c - 'A' + 'a');
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t entry_hash(int section, const char* key) {
+    return fold_hash(key, (uint32_t)section * 0x9E3779B1u);
+}
+
+static size_t pool_add(IniIndex* index, const char* s) {
+    size_t len = strlen(s) + 1;
+    if (index->pool_len + len > index->pool_cap) {
+        size_t cap = index->pool_cap ? index->pool_cap : 1024;
+        while (index->pool_len + len > cap) cap *= 2;
+        char* pool = (char*)realloc(index->pool, cap);
+        if (!pool) {
+            index->failed = true;
+            return (size_t)-1;
+        }
+        index->pool = pool;
+        index->pool_cap = cap;
+    }
+    size_t off = index->pool_len;
+    memcpy(index->pool + off, s, len);
+    index->pool_len += len;
+    return off;
+}
+
+static bool add_section(IniIndex* index, const char* name) {
+    if (index->num_sections == index->sections_cap) {
+        int cap = index->sections_cap ? index->sections_cap * 2 : 16;
+        IniSection* sections = (IniSection*)realloc(index->sections, (size_t)cap * sizeof(IniSection));
+        if (!sections) return false;
+        index->sections = sections;
+        index->sections_cap = cap;
+    }
+    size_t off = pool_add(index, name);
+    if (index->failed) return false;
+    index->sections[index->num_sections].name_off = off;
+    index->sections[index->num_sections].first = index->num_sections;
+    index->num_sections++;
+    return true;
+}
+
+// ini_browse 콜백. 섹션 이름이 바뀌면 새 섹션으로 센다. 1을 반환해야 계속 읽는다
+static int browse_callback(const char* section, const char* key, const char* value, void* user_data) {
+    IniIndex* index = (IniIndex*)user_data;
+
+    if (index->num_sections == 0 ||
+        strcmp(index->pool + index->sections[index->num_sections - 1].name_off, section) != 0) {
+        if (!add_section(index, section)) {
+            index->failed = true;
+            return 0;
+        }
+    }
+
+    if (index->num_entries == index->entries_cap) {
+        int cap = index->entries_cap ? index->entries_cap * 2 : 64;
+        IniEntry* entries = (IniEntry*)realloc(index->entries, (size_t)cap * sizeof(IniEntry));
+        if (!entries) {
+            index->failed = true;
+            return 0;
+        }
+        index->entries = entries;
+        index->entries_cap = cap;
+    }
+    IniEntry* entry = &index->entries[index->num_entries];
+    entry->section = index->num_sections - 1;
+    entry->key_off = pool_add(index, key);
+    entry->value_off = pool_add(index, value);
+    if (index->failed) return 0;
+    index->num_entries++;
+    return 1;
+}
+
+static size_t table_size_for(int count) {
+    size_t size = 16;
+    while (size < (size_t)count * 2) size <<= 1;
+    return size;
+}
+
+// 섹션 이름으로 처음 나온 섹션 번호를 찾는다. 없으면 -1
+static int find_section(const IniIndex* index, const char* name) {
+    if (!index->section_table) return -1;
+    for (size_t slot = fold_hash(name, 0) & index->section_mask;; slot = (slot + 1) & index->section_mask) {
+        int s = index->section_table[slot];
+        if (s < 0) return -1;
+        if (strcasecmp(index->pool + index->sections[s].name_off, name) == 0) return s;
+    }
+}
+
+static int find_entry(const IniIndex* index, int section, const char* key, uint32_t hash) {
+    if (!index->entry_table) return -1;
+    for (size_t slot = hash & index->entry_mask;; slot = (slot + 1) & index->entry_mask) {
+        int e = index->entry_table[slot];
+        if (e < 0) return -1;
+        const IniEntry* entry = &index->entries[e];
+        if (entry->hash == hash && entry->section == section &&
+            strcasecmp(index->pool + entry->key_off, key) == 0) {
+            return e;
+        }
+    }
+}
+
+// 다 읽은 뒤 해시 테이블을 한 번에 만든다
+static bool build_tables(IniIndex* index) {
+    size_t section_size = table_size_for(index->num_sections);
+    size_t entry_size = table_size_for(index->num_entries);
+    index->section_table = (int*)malloc(section_size * sizeof(int));
+    index->entry_table = (int*)malloc(entry_size * sizeof(int));
+    if (!index->section_table || !index->entry_table) return false;
+    memset(index->section_table, 0xff, section_size * sizeof(int));
+    memset(index->entry_table, 0xff, entry_size * sizeof(int));
+    index->section_mask = section_size - 1;
+    index->entry_mask = entry_size - 1;
+
+    for (int i = 0; i < index->num_sections; ++i) {
+        const char* name = index->pool + index->sections[i].name_off;
+        int first = find_section(index, name);
+        if (first >= 0) {
+            index->sections[i].first = first;
+            continue;
+        }
+        size_t slot = fold_hash(name, 0) & index->section_mask;
+        while (index->section_table[slot] >= 0) slot = (slot + 1) & index->section_mask;
+        index->section_table[slot] = i;
+    }
+
+    for (int e = 0; e < index->num_entries; ++e) {
+        IniEntry* entry = &index->entries[e];
+        // 다시 나온 같은 이름 섹션의 키는 minIni처럼 찾지 않는다
+        if (index->sections[entry->section].first != entry->section) continue;
+        const char* key = index->pool + entry->key_off;
+        entry->hash = entry_hash(entry->section, key);
+        if (find_entry(index, entry->section, key, entry->hash) >= 0) continue; // 같은 키는 처음 값
+        size_t slot = entry->hash & index->entry_mask;
+        while (index->entry_table[slot] >= 0) slot = (slot + 1) & index->entry_mask;
+        index->entry_table[slot] = e;
+    }
+    return true;
+}
+
+IniIndex* ini_index_load(const char* filepath) {
+    if (!filepath) return NULL;
+    IniIndex* index = (IniIndex*)calloc(1, sizeof(IniIndex));
+    if (!index) {
+        perror("Failed to allocate IniIndex");
+        return NULL;
+    }
+    if (!ini_browse(browse_callback, index, filepath)) {
+        fprintf(stderr, "[IniIndex] Warning: Could not open %s. Using defaults.\n", filepath);
+        ini_index_free(index);
+        return NULL;
+    }
+    if (index->num_sections > 0 && index->pool[index->sections[0].name_off] == '\0') index->first_named = 1;
+    if (index->failed || !build_tables(index)) {
+        fprintf(stderr, "[IniIndex] Error: Out of memory while indexing %s.\n", filepath);
+        ini_index_free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void ini_index_free(IniIndex* index) {
+    if (!index) return;
+    free(index->pool);
+    free(index->sections);
+    free(index->entries);
+    free(index->section_table);
+    free(index->entry_table);
+    free(index);
+}
+
+int ini_index_num_sections(const IniIndex* index) {
+    return index ? index->num_sections - index->first_named : 0;
+}
+
+const char* ini_index_section_name(const IniIndex* index, int idx) {
+    if (!index || idx < 0 || idx >= index->num_sections - index->first_named) return NULL;
+    return index->pool + index->sections[idx + index->first_named].name_off;
+}
+
+const char* ini_index_get(const IniIndex* index, const char* section, const char* key) {
+    if (!index || !key) return NULL;
+    int s = find_section(index, section ? section : "");
+    if (s < 0) return NULL;
+    int e = find_entry(index, s, key, entry_hash(s, key));
+    return (e >= 0) ? index->pool + index->entries[e].value_off : NULL;
+}
+
+int ini_index_gets(const IniIndex* index, const char* section, const char* key, const char* def_value,
+                   char* buffer, int buffer_size) {
+    if (!buffer || buffer_size <= 0) return 0;
+    const char* value = ini_index_get(index, section, key);
+    if (!value) value = def_value ? def_value : "";
+    size_t len = strlen(value);
+    if (len > (size_t)buffer_size - 1) len = (size_t)buffer_size - 1;
+    memcpy(buffer, value, len);
+    buffer[len] = '\0';
+    return (int)len;
+}
+
+long ini_index_getl(const IniIndex* index, const char* section, const char* key, long def_value) {
+    const char* value = ini_index_get(index, section, key);
+    if (!value || value[0] == '\0') return def_value;
+    bool hex = (value[1] == 'x' || value[1] == 'X');
+    return strtol(value, NULL, hex ? 16 : 10);
+}
+
+double ini_index_getf(const IniIndex* index, const char* section, const char* key, double def_value) {
+    const char* value = ini_index_get(index, section, key);
+    if (!value || value[0] == '\0') return def_value;
+    return strtod(value, NULL);
+}
+
+int ini_index_getbool(const IniIndex* index, const char* section, const char* key, int def_value) {
+    const char* value = ini_index_get(index, section, key);
+    if (!value) return def_value;
+    switch (value[0]) {
+        case 'Y': case 'y': case 'T': case 't': case '1': return 1;
+        case 'N': case 'n': case 'F': case 'f': case '0': return 0;
+        default: return def_value;
+    }
+}
@@ -0,0 +1,66 @@
+// ini_index.h
+
+#ifndef INI_INDEX_H
+#define INI_INDEX_H
+
+#include <stddef.h>
+
+// INI 파일을 ini_browse 한 번으로 읽어 메모리에 올린 색인.
+// 키 하나를 읽을 때마다 파일을 다시 열고 처음부터 훑는 ini_gets/ini_getl 대신 사용한다.
+// 조회 규칙은 minIni와 같다: 섹션/키 이름은 대소문자 구분 없이 비교하고, 같은 이름의 섹션이
+// 여러 번 나오면 처음 나온 섹션의 키만, 같은 키가 여러 번 나오면 처음 값만 찾는다.
+// 만든 뒤에는 읽기 전용이다.
+typedef struct IniIndex IniIndex;
+
+/**
+ * @brief INI 파일을 읽어 색인을 만듭니다.
+ * @param filepath INI 파일 경로.
+ * @return 색인 포인터. 파일을 열 수 없거나 메모리가 부족하면 NULL.
+ *         (NULL 색인으로 조회하면 항상 기본값을 반환하므로 minIni처럼 파일이 없어도 기본값으로 동작한다)
+ */
+IniIndex* ini_index_load(const char* filepath);
+
+/**
+ * @brief 색인을 해제합니다.
+ */
+void ini_index_free(IniIndex* index);
+
+/**
+ * @brief 파일에 나온 순서대로의 섹션 수. (ini_getsection으로 열거하던 것과 같은 순서, 같은 이름이 다시 나오면 따로 센다)
+ *        키가 하나도 없는 섹션은 ini_browse가 알려 주지 않으므로 포함되지 않는다.
+ */
+int ini_index_num_sections(const IniIndex* index);
+
+/**
+ * @brief idx번째 섹션 이름. 범위를 벗어나면 NULL.
+ */
+const char* ini_index_section_name(const IniIndex* index, int idx);
+
+/**
+ * @brief 키 값을 찾습니다. 없으면 NULL.
+ */
+const char* ini_index_get(const IniIndex* index, const char* section, const char* key);
+
+/**
+ * @brief ini_gets와 같습니다. 값(없으면 def_value)을 buffer_size에 맞춰 잘라 복사합니다.
+ * @return 복사한 문자열 길이.
+ */
+int ini_index_gets(const IniIndex* index, const char* section, const char* key, const char* def_value,
+                   char* buffer, int buffer_size);
+
+/**
+ * @brief ini_getl과 같습니다. "0x"로 시작하면 16진수로 읽습니다.
+ */
+long ini_index_getl(const IniIndex* index, const char* section, const char* key, long def_value);
+
+/**
+ * @brief ini_getf와 같지만 strtod로 읽어 double 정밀도를 유지합니다.
+ */
+double ini_index_getf(const IniIndex* index, const char* section, const char* key, double def_value);
+
+/**
+ * @brief ini_getbool과 같습니다. 'Y'/'T'/'1'로 시작하면 1, 'N'/'F'/'0'으로 시작하면 0, 그 밖에는 def_value.
+ */
+int ini_index_getbool(const IniIndex* index, const char* section, const char* key, int def_value);
+
+#endif // INI_INDEX_H
@@ -0,0 +1,160 @@
+// pipeline.c
+
+#include "pipeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PIPELINE_POP_TIMEOUT_MS 200 // 종료 플래그 확인 주기
+
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void* pipeline_stage_thread_func(void* arg) {
+    PipelineStage* stage = (PipelineStage*)arg;
+    printf("[Pipeline] Stage '%s' thread started.\n", stage->desc.name);
+
+    while (1) {
+        void* item = ring_queue_pop(stage->input, PIPELINE_POP_TIMEOUT_MS);
+        if (!item) {
+            // 큐가 닫히고 남은 항목도 모두 처리했으면 종료
+            if (atomic_load(&stage->input->closed) && ring_queue_size(stage->input) == 0) break;
+            continue;
+        }
+
+        long long start_ns = monotonic_ns();
+        void* out = stage->desc.process(item, stage->desc.user_data);
+        atomic_fetch_add_explicit(&stage->busy_ns, (unsigned long)(monotonic_ns() - start_ns), memory_order_relaxed);
+        atomic_fetch_add_explicit(&stage->processed, 1, memory_order_relaxed);
+
+        if (out) {
+            if (stage->output) {
+                ring_queue_push(stage->output, out);
+            } else {
+                fprintf(stderr, "[Pipeline] Stage '%s' returned an item but has no next stage.\n", stage->desc.name);
+            }
+        }
+    }
+
+    printf("[Pipeline] Stage '%s' thread finishing.\n", stage->desc.name);
+    return NULL;
+}
+
+Pipeline* pipeline_create(const PipelineStageDesc* descs, int num_stages, size_t queue_depth, RingQueuePolicy policy) {
+    if (!descs || num_stages <= 0 || num_stages > PIPELINE_MAX_STAGES) return NULL;
+
+    Pipeline* pipeline = (Pipeline*)calloc(1, sizeof(Pipeline));
+    if (!pipeline) {
+        perror("Failed to allocate Pipeline");
+        return NULL;
+    }
+    pipeline->num_stages = num_stages;
+    atomic_init(&pipeline->running, false);
+
+    for (int i = 0; i < num_stages; ++i) {
+        PipelineStage* stage = &pipeline->stages[i];
+        stage->desc = descs[i];
+        atomic_init(&stage->processed, 0);
+        atomic_init(&stage->busy_ns, 0);
+        stage->input = ring_queue_create(queue_depth, policy, descs[i].free_input);
+        if (!stage->input) {
+            pipeline_destroy(pipeline);
+            return NULL;
+        }
+    }
+    for (int i = 0; i + 1 < num_stages; ++i) {
+        pipeline->stages[i].output = pipeline->stages[i + 1].input;
+    }
+
+    printf("[Pipeline] Created %d stages (queue depth: %zu, overflow policy: %s)\n",
+           num_stages, pipeline->stages[0].input->capacity, ring_queue_policy_name(policy));
+    return pipeline;
+}
+
+bool pipeline_start(Pipeline* pipeline) {
+    if (!pipeline) return false;
+    atomic_store(&pipeline->running, true);
+    pipeline->last_report_ms = monotonic_ns() / 1000000;
+
+    for (int i = 0; i < pipeline->num_stages; ++i) {
+        PipelineStage* stage = &pipeline->stages[i];
+        if (pthread_create(&stage->thread, NULL, pipeline_stage_thread_func, stage) != 0) {
+            perror("[Pipeline] 스테이지 스레드 생성 실패");
+            pipeline_stop(pipeline);
+            return false;
+        }
+        stage->thread_started = true;
+    }
+    return true;
+}
+
+bool pipeline_submit(Pipeline* pipeline, void* item) {
+    if (!pipeline || !item) return false;
+    return ring_queue_push(pipeline->stages[0].input, item);
+}
+
+void pipeline_report(Pipeline* pipeline, int interval_ms) {
+    if (!pipeline) return;
+
+    long long now_ms = monotonic_ns() / 1000000;
+    long long elapsed_ms = now_ms - pipeline->last_report_ms;
+    if (elapsed_ms < interval_ms || elapsed_ms <= 0) return;
+    pipeline->last_report_ms = now_ms;
+
+    printf("[Pipeline] ---- stage report (%.1fs) ----\n", elapsed_ms / 1000.0);
+
+    // 첫 스테이지 입력 큐에 들어온 항목 수 = 수신(생산자) 스테이지 처리량
+    RingQueue* first = pipeline->stages[0].input;
+    unsigned long submitted = atomic_load_explicit(&first->pushed, memory_order_relaxed);
+    printf("[Pipeline] %-8s %8.1f items/s\n", "recv", (submitted - pipeline->last_submitted) * 1000.0 / elapsed_ms);
+    pipeline->last_submitted = submitted;
+
+    for (int i = 0; i < pipeline->num_stages; ++i) {
+        PipelineStage* stage = &pipeline->stages[i];
+        RingQueue* q = stage->input;
+        unsigned long processed = atomic_load_explicit(&stage->processed, memory_order_relaxed);
+        unsigned long busy_ns = atomic_load_explicit(&stage->busy_ns, memory_order_relaxed);
+
+        double rate = (processed - stage->last_processed) * 1000.0 / elapsed_ms;
+        double busy_pct = (busy_ns - stage->last_busy_ns) / (elapsed_ms * 10000.0);
+        double avg_us = (processed > stage->last_processed)
+                      ? (busy_ns - stage->last_busy_ns) / 1000.0 / (processed - stage->last_processed) : 0.0;
+        stage->last_processed = processed;
+        stage->last_busy_ns = busy_ns;
+
+        printf("[Pipeline] %-8s %8.1f items/s  busy %5.1f%%  avg %8.1f us | queue %zu/%zu (max %zu) dropped %lu\n",
+               stage->desc.name, rate, busy_pct, avg_us,
+               ring_queue_size(q), q->capacity,
+               atomic_load_explicit(&q->high_watermark, memory_order_relaxed),
+               atomic_load_explicit(&q->dropped, memory_order_relaxed));
+    }
+}
+
+void pipeline_stop(Pipeline* pipeline) {
+    if (!pipeline) return;
+    atomic_store(&pipeline->running, false);
+
+    // 앞 스테이지부터 닫고 기다려서, 이미 들어온 항목은 뒤 스테이지까지 흘려보낸다
+    for (int i = 0; i < pipeline->num_stages; ++i) {
+        PipelineStage* stage = &pipeline->stages[i];
+        ring_queue_close(stage->input);
+        if (stage->thread_started) {
+            pthread_join(stage->thread, NULL);
+            stage->thread_started = false;
+        }
+    }
+}
+
+void pipeline_destroy(Pipeline* pipeline) {
+    if (!pipeline) return;
+    pipeline_stop(pipeline);
+    for (int i = 0; i < pipeline->num_stages; ++i) {
+        ring_queue_destroy(pipeline->stages[i].input); // 남은 항목은 free_input으로 해제
+        pipeline->stages[i].input = NULL;
+    }
+    free(pipeline);
+}
@@ -0,0 +1,85 @@
+// pipeline.h
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ring_queue.h"
+
+#define PIPELINE_MAX_STAGES 8
+
+// 스테이지 처리 함수. 입력 항목을 처리하고 다음 스테이지로 넘길 항목을 반환 (없으면 NULL)
+// 입력 항목의 해제 책임은 처리 함수에 있다.
+typedef void* (*PipelineStageFn)(void* item, void* user_data);
+
+// 스테이지 정의
+typedef struct {
+    const char* name;            // 로그용 스테이지 이름 (예: "parse")
+    PipelineStageFn process;     // 처리 함수
+    RingQueueFreeFn free_input;  // 입력 큐에서 버려진 항목 해제 함수
+    void* user_data;             // 처리 함수에 전달할 사용자 데이터
+} PipelineStageDesc;
+
+// 전용 스레드 하나가 입력 큐를 소비하는 스테이지
+typedef struct {
+    PipelineStageDesc desc;
+    RingQueue* input;            // 이 스테이지의 입력 큐
+    RingQueue* output;           // 다음 스테이지의 입력 큐 (마지막 스테이지는 NULL)
+    pthread_t thread;
+    bool thread_started;
+    atomic_ulong processed;      // 처리한 항목 수
+    atomic_ulong busy_ns;        // 처리 함수에서 보낸 누적 시간 (나노초)
+    unsigned long last_processed; // 직전 보고 시점의 processed (처리량 계산용)
+    unsigned long last_busy_ns;
+} PipelineStage;
+
+// 스테이지들을 고정 크기 lock-free 큐로 연결한 처리 파이프라인
+typedef struct {
+    PipelineStage stages[PIPELINE_MAX_STAGES];
+    int num_stages;
+    atomic_bool running;
+    long long last_report_ms;
+    unsigned long last_submitted; // 직전 보고 시점의 첫 입력 큐 pushed (수신 처리량 계산용)
+} Pipeline;
+
+/**
+ * @brief 파이프라인을 생성합니다. 스테이지 i의 출력은 스테이지 i+1의 입력 큐로 연결됩니다.
+ * @param descs 스테이지 정의 배열.
+ * @param num_stages 스테이지 수 (최대 PIPELINE_MAX_STAGES).
+ * @param queue_depth 각 입력 큐의 크기.
+ * @param policy 입력 큐가 가득 찼을 때의 처리 정책.
+ * @return 성공 시 Pipeline 포인터 (pipeline_destroy로 해제), 실패 시 NULL.
+ */
+Pipeline* pipeline_create(const PipelineStageDesc* descs, int num_stages, size_t queue_depth, RingQueuePolicy policy);
+
+/**
+ * @brief 스테이지마다 전용 스레드를 시작합니다.
+ * @return 성공 시 true.
+ */
+bool pipeline_start(Pipeline* pipeline);
+
+/**
+ * @brief 첫 스테이지의 입력 큐에 항목을 넣습니다. (단일 생산자 스레드에서만 호출)
+ * @return 큐에 들어갔으면 true. 정책에 의해 버려졌으면 false (항목은 이미 해제됨).
+ */
+bool pipeline_submit(Pipeline* pipeline, void* item);
+
+/**
+ * @brief 스테이지별 처리량, 처리 시간 비율, 입력 큐 점유율을 출력합니다.
+ * @param interval_ms 이 시간 이상 지났을 때만 출력 (0이면 항상 출력).
+ */
+void pipeline_report(Pipeline* pipeline, int interval_ms);
+
+/**
+ * @brief 모든 큐를 닫고 스테이지 스레드가 끝날 때까지 기다립니다.
+ */
+void pipeline_stop(Pipeline* pipeline);
+
+/**
+ * @brief 파이프라인을 해제합니다. 큐에 남은 항목은 각 스테이지의 free_input으로 해제됩니다.
+ */
+void pipeline_destroy(Pipeline* pipeline);
+
+#endif // PIPELINE_H
@@ -10,14 +10,16 @@
 
 #include <sys/socket.h>
 #include <errno.h>
-#include <sys/time.h>
-#include <sys/select.h>
 
 #include "VMSconnection_manager.h"
 #include "VMSprotocol.h"
 #include "sds_json_types.h"
 #include "VMScontroller.h"
 #include "scenario_manager.h"
+#include "ingest_server.h"
+#include "pipeline.h"
+#include "sds_coalescer.h"
+#include "config_reloader.h"
 
 #define RCV_BUF_SIZE 1024*30 // 수신 버퍼 크기
 
@@ -33,148 +35,32 @@ void* connection_manager_thread_func(void* arg) {
     return NULL;
 }
 
-// 특정 그룹의 모든 연결된 서버에게 메시지를 전송하는 함수 (뮤텍스 사용)
-void send_message_to_group_thread_safe(VMSServers* all_servers, int target_group_id, const char* message, size_t message_len) {
-    if (!all_servers || !message || message_len == 0) {
-        fprintf(stderr, "[Sender] 잘못된 인자입니다.\n");
-        return;
-    }
-
-    // 공유 데이터 접근 전 뮤텍스 잠금
-    pthread_mutex_lock(&all_servers->mutex);
-
-    VMSServerGroup* group_to_send = NULL;
-    for (int i = 0; i < all_servers->num_groups; ++i) {
-        if (all_servers->groups[i].group_id == target_group_id) {
-            group_to_send = &all_servers->groups[i];
-            break;
-        }
-    }
-
-    if (!group_to_send) {
-        fprintf(stderr, "[Sender] 그룹 ID %d 를 찾을 수 없습니다.\n", target_group_id);
-        pthread_mutex_unlock(&all_servers->mutex); // 리턴 전 반드시 잠금 해제
-        return;
-    }
-
-    printf("[Sender] 그룹 %d (%d개 서버)에 메시지 전송 시도 (뮤텍스 잠금 상태)...\n",
-           target_group_id, group_to_send->num_servers);
-
-    for (int i = 0; i < group_to_send->num_servers; ++i) {
-        VMSServerInfo* server = &group_to_send->servers[i];
-        int current_socket_handle = server->socket_handle; // 핸들 값 복사
-
-        if (current_socket_handle != -1) {
-            printf("[Sender]   -> %s:%d (그룹 %d, 핸들: %d) 에 전송 중...\n",
-                   server->ip_address, server->port, server->group_id_for_log, current_socket_handle);
-
-            ssize_t total_bytes_sent = 0;
-            while ((size_t)total_bytes_sent < message_len) {
-                ssize_t bytes_sent_this_call = send(current_socket_handle, // 복사된 핸들 사용
-                                                    message + total_bytes_sent,
-                                                    message_len - total_bytes_sent,
-                                                    MSG_NOSIGNAL);
-
-                if (bytes_sent_this_call < 0) {
-                    fprintf(stderr, "[Sender]   ERROR: %s:%d 로 전송 실패 (에러: %s).\n",
-                           server->ip_address, server->port, strerror(errno));
-                    if(server->socket_handle == current_socket_handle) { // 아직 매니저가 바꾸지 않았다면
-                        close(server->socket_handle);
-                        server->socket_handle = -1;
-                    }
-                    break; 
-                } else if (bytes_sent_this_call == 0) {
-                     fprintf(stderr, "[Sender]   WARNING: %s:%d 로 전송 시 0 바이트 전송됨.\n",
-                           server->ip_address, server->port);
-                    if(server->socket_handle == current_socket_handle) {
-                        close(server->socket_handle);
-                        server->socket_handle = -1;
-                    }
-                    break;
-                }
-                total_bytes_sent += bytes_sent_this_call;
-            }
-            if ((size_t)total_bytes_sent == message_len) {
-                printf("[Sender]   SUCCESS: %s:%d 로 %ld 바이트 전송 완료.\n",
-                       server->ip_address, server->port, total_bytes_sent);
-            }
-        } else {
-            printf("[Sender]   SKIP: %s:%d (그룹 %d)는 연결되지 않음 (핸들: -1).\n",
-                   server->ip_address, server->port, server->group_id_for_log);
-        }
-    }
-    // 모든 작업 완료 후 뮤텍스 잠금 해제
-    pthread_mutex_unlock(&all_servers->mutex);
-}
-
-// 그룹별로 우선순위 높은 메시지 정보를 저장하는 구조체
-typedef struct {
-    int group_id;
-    int message_template_id; // 메시지 템플릿 번호 (1, 2, 3, 4...)
-    // 페이로드 생성에 필요한 동적 데이터를 여기에 추가 가능
-    double speed;
-    double pet;
-    int dir_code;
-} WinningMessage;
-
-// 구조체 리스트
-typedef struct {
-    WinningMessage* messages;
-    int count;
-} WinningMessageList;
-
-// WinningMessageList에 메시지 정보를 업데이트/추가하는 함수
-// 동일한 group_id에 대해 더 높은 message_template_id가 들어오면 교체
-static void upsert_winning_message(WinningMessageList* list, int group_id, int message_id, const SdsJson_ApproachTrafficInfoData_t* ati) {
-    
-    // 1. 이미 해당 그룹에 대한 결정이 있는지 확인
-    for (int i = 0; i < list->count; ++i) {
-        if (list->messages[i].group_id == group_id) {
-            // 이미 존재. 메시지 ID가 더 높으면 업데이트
-            if (message_id > list->messages[i].message_template_id) {
-                list->messages[i].message_template_id = message_id;
-                // 페이로드 생성에 필요한 데이터도 함께 업데이트
-                if(ati && ati->host_object.num_way_points > 0) {
-                     list->messages[i].speed = ati->host_object.way_point_list[0].speed;
-                     list->messages[i].dir_code = ati->cvib_dir_code;
-                }
-                if(ati && ati->has_pet) {
-                    list->messages[i].pet = ati->pet;
-                }
-            }
-            return;
-        }
-    }
-    // 2. 해당 그룹에 대한 결정이 없으면 새로 추가
-    list->count++;
-    WinningMessage* new_array = (WinningMessage*)realloc(list->messages, sizeof(WinningMessage) * list->count);
-    if (!new_array) {
-        perror("Failed to realloc WinningMessageList");
-        list->count--;
-        return;
+// 서버 하나의 송신 큐에 패킷을 넣는 함수
+// 서버마다 자기 송신 큐 잠금만 잡으므로 다른 서버의 전송이나 재연결과 경합하지 않는다.
+// 실제 전송은 논블로킹으로 이루어지므로 느린 서버가 다른 서버나 호출 스레드를 막지 않는다.
+static void send_packet_to_server(VMSServerInfo* server, VMS_PacketBuffer_t* packet) {
+    switch (vms_send_queue_push(&server->send_queue, packet)) {
+    case VMS_SEND_SENT:
+        printf("[Sender]   SUCCESS: %s:%d 로 %u 바이트 전송 완료.\n",
+               server->ip_address, server->port, (unsigned)packet->len);
+        break;
+    case VMS_SEND_QUEUED:
+        printf("[Sender]   QUEUED: %s:%d (그룹 %d) 송신 큐에 추가.\n",
+               server->ip_address, server->port, server->group_id_for_log);
+        break;
+    case VMS_SEND_COALESCED:
+        printf("[Sender]   COALESCED: %s:%d (그룹 %d) 미전송 이전 메시지를 새 메시지로 대체.\n",
+               server->ip_address, server->port, server->group_id_for_log);
+        break;
+    case VMS_SEND_DROPPED_OLDEST:
+        fprintf(stderr, "[Sender]   WARNING: %s:%d 송신 큐가 가득 차 가장 오래된 패킷을 버림.\n",
+                server->ip_address, server->port);
+        break;
+    case VMS_SEND_NOT_CONNECTED:
+        printf("[Sender]   SKIP: %s:%d (그룹 %d)는 연결되지 않음.\n",
+               server->ip_address, server->port, server->group_id_for_log);
+        break;
     }
-    list->messages = new_array;
-
-    WinningMessage* new_decision = &list->messages[list->count - 1];
-    new_decision->group_id = group_id;
-    new_decision->message_template_id = message_id;
-    // 페이로드 생성에 필요한 데이터 저장
-    if(ati && ati->host_object.num_way_points > 0) {
-        new_decision->speed = ati->host_object.way_point_list[0].speed;
-        new_decision->dir_code = ati->cvib_dir_code;
-    }
-    if(ati && ati->has_pet) {
-        new_decision->pet = ati->pet;
-    }
-}
-
-// WinningMessageList 메모리 해제 함수
-static void free_winning_message_list(WinningMessageList* list) {
-    if (!list) return;
-    if (list->messages) {
-        free(list->messages);
-    }
-    free(list);
 }
 
 // 서버 리스닝 소켓을 설정하고 반환하는 함수
@@ -219,20 +105,229 @@ int setup_listening_socket(int port, const char* ip_addr_str) {
     return server_sock;
 }
 
-// 수신 버퍼에서 완전한 JSON 메시지(\n 으로 구분)를 추출하는 함수
-char* extract_json_message(char* buffer) {
-    char* newline = strchr(buffer, '!');
-    // printf("\n [디버깅] %s\n%s\n", newline, buffer);
-    if (newline == NULL) {
-        return NULL; // 아직 완전한 메시지가 도착하지 않음
+// 수신 스테이지에서 파싱 스테이지로 넘기는 프레임 복사본
+typedef struct {
+    size_t len;
+    char data[];            // 널 종료된 JSON 문자열
+} FrameItem;
+
+// 서버(IP:PORT) 하나의 전송 상태 (send 스테이지 전용, 서버 구성의 인덱스 순)
+typedef struct {
+    const VMSServerInfo* server;        // 이 칸의 서버 (구성이 바뀌면 같은 서버의 기록을 새 인덱스로 옮긴다)
+    const VMS_MessageToSend_t* choice;  // 이번 프레임에 이긴 메시지 (프레임 사이에는 NULL)
+    int choice_group_id;                // choice를 결정한 그룹
+    unsigned long won_frame;            // 마지막으로 이긴 메시지가 있었던 프레임 번호
+    int won_template_id;                // 그 프레임에 이긴 메시지 ID (없으면 -1)
+    int won_group_id;                   // 그 메시지를 결정한 그룹
+} ServerSendState;
+
+// 프레임 처리에 필요한 공유 상태 (수신 콜백과 파이프라인 스테이지에 전달)
+typedef struct {
+    VMSServers* vms_servers;
+    VMSTopologyReader* topology_reader;    // send 스테이지의 서버 구성 hazard
+    ConfigReloader* reloader;              // 설정/시나리오 스냅샷 (핫 리로드)
+    ConfigReader* config_reader;           // decide 스테이지의 스냅샷 hazard
+    unsigned long decision_version;        // decision을 만든 스냅샷 버전
+    VMS_DecisionState_t decision;          // 그룹별 메시지 결정 상태 (decide 스테이지 전용)
+    ServerSendState* server_states;        // 서버별 전송 상태 (send 스테이지 전용, 서버 수 크기)
+    int* chosen_servers;                   // 이번 프레임에 choice를 채운 서버 인덱스 목록
+    int num_server_states;
+    unsigned long server_states_version;   // server_states를 맞춘 서버 구성 버전 (0이면 아직 없음)
+    unsigned long send_frame;              // send 스테이지가 처리한 프레임 수
+    Pipeline* pipeline;                    // 파이프라인 모드가 아니면 NULL
+    SdsCoalescer* coalescer;               // 최신 프레임 우선 모드가 아니면 NULL
+} ReaderContext;
+
+static void free_message_list_item(void* item) {
+    free_vms_message_list((VMS_MessageList_t*)item);
+}
+
+static void free_parsed_message_item(void* item) {
+    free_sds_json_main_message((SdsJson_MainMessage_t*)item);
+}
+
+// 파싱된 메시지로 그룹별 메시지를 결정하고, 직전 프레임과 달라진 그룹의 패킷만 만든다.
+// parsed_message는 이 함수에서 해제된다.
+// 프레임마다 현재 설정 스냅샷을 잠금 없이 잡고, 프레임이 끝나면 놓는다.
+static VMS_MessageList_t* decide_outbound_messages(ReaderContext* ctx, SdsJson_MainMessage_t* parsed_message) {
+    const VMS_ConfigSnapshot_t* snapshot = config_reader_enter(ctx->reloader, ctx->config_reader);
+    if (snapshot->version != ctx->decision_version) {
+        // 설정이 바뀌면 슬롯 표를 다시 만들고 직전 프레임 결정을 비워 모든 그룹에 새 설정으로 다시 보낸다
+        vms_controller_init_decision_state(&ctx->decision, &snapshot->config, snapshot->scenario_list);
+        ctx->decision_version = snapshot->version;
     }
-    printf("\n\n    [디버깅] 개행 문자 발견\n\n");
-    *newline = '\0'; // 개행 문자를 널 문자로 대체하여 문자열 분리
-    char* json_message = strdup(buffer); // 분리된 JSON 메시지 복사
-    // 버퍼의 나머지 부분을 앞으로 당김
-    memmove(buffer, newline + 1, strlen(newline + 1) + 1);
+    VMS_MessageList_t* message_list = vms_controller_determine_messages(&ctx->decision, parsed_message);
+    config_reader_leave(ctx->config_reader);
+    free_sds_json_main_message(parsed_message);
+    return message_list;
+}
 
-    return json_message;
+// 서버 구성이 바뀌면 서버별 전송 상태를 새 구성의 인덱스에 맞춘다.
+// 두 구성에 모두 있는 서버는 같은 VMSServerInfo를 이어 쓰므로 그 포인터로 직전에 이긴 메시지 기록을 옮긴다.
+static bool sync_server_states(ReaderContext* ctx, const VMSTopology* topology) {
+    size_t capacity = (size_t)(topology->num_servers > 0 ? topology->num_servers : 1);
+    ServerSendState* states = (ServerSendState*)calloc(capacity, sizeof(*states));
+    int* chosen_servers = (int*)calloc(capacity, sizeof(*chosen_servers));
+    if (!states || !chosen_servers) {
+        free(states);
+        free(chosen_servers);
+        return false;
+    }
+    for (int i = 0; i < topology->num_servers; ++i) {
+        ServerSendState* st = &states[i];
+        st->server = topology->servers[i];
+        st->won_template_id = -1;
+        for (int k = 0; k < ctx->num_server_states; ++k) {
+            const ServerSendState* old = &ctx->server_states[k];
+            if (old->server == st->server) {
+                st->won_frame = old->won_frame;
+                st->won_template_id = old->won_template_id;
+                st->won_group_id = old->won_group_id;
+                break;
+            }
+        }
+    }
+    free(ctx->server_states);
+    free(ctx->chosen_servers);
+    ctx->server_states = states;
+    ctx->chosen_servers = chosen_servers;
+    ctx->num_server_states = topology->num_servers;
+    ctx->server_states_version = topology->version;
+    return true;
+}
+
+// 결정된 패킷들을 대상 그룹의 서버로 전송하고 리스트를 해제한다.
+// 내용이 같은 그룹들은 한 번 만든 패킷을 함께 사용한다.
+// 서버(IP:PORT)마다 속한 모든 그룹의 현재 결정 중에서 그룹 결정과 같은 규칙(메시지 ID가 높은 쪽, 같으면 그룹 ID가 작은 쪽)으로
+// 이긴 메시지 하나를 고르고, 직전 프레임에 이긴 메시지와 같으면 보내지 않는다.
+// 프레임마다 현재 서버 구성을 잠금 없이 잡고, 전송이 끝나면 놓는다.
+static void send_outbound_messages(ReaderContext* ctx, VMS_MessageList_t* message_list) {
+    VMSServers* vms_servers = ctx->vms_servers;
+    const VMSTopology* topology = vms_manager_enter(vms_servers, ctx->topology_reader);
+    int num_chosen = 0;
+
+    if (topology->version != ctx->server_states_version && !sync_server_states(ctx, topology)) {
+        fprintf(stderr, "[Sender] 서버별 전송 테이블 할당 실패. 이번 프레임은 보내지 않습니다.\n");
+        vms_manager_leave(ctx->topology_reader);
+        free_vms_message_list(message_list);
+        return;
+    }
+    unsigned long frame = ++ctx->send_frame;
+
+    for (int i = 0; i < message_list->count; ++i) {
+        const VMS_MessageToSend_t* msg = &message_list->messages[i];
+        for (int j = 0; j < msg->num_target_groups; ++j) {
+            int group_id = msg->target_group_ids[j];
+            const VMSServerGroup* group = vms_manager_find_group(topology, group_id);
+            if (!group) {
+                fprintf(stderr, "[Sender] 그룹 ID %d 를 찾을 수 없습니다.\n", group_id);
+                continue;
+            }
+            for (int k = 0; k < group->num_servers; ++k) {
+                int server_id = group->server_ids[k];
+                ServerSendState* st = &ctx->server_states[server_id];
+                if (!st->choice) {
+                    st->choice = msg;
+                    st->choice_group_id = group_id;
+                    ctx->chosen_servers[num_chosen++] = server_id;
+                } else if (msg->message_template_id > st->choice->message_template_id ||
+                           (msg->message_template_id == st->choice->message_template_id && group_id < st->choice_group_id)) {
+                    st->choice = msg;
+                    st->choice_group_id = group_id;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < num_chosen; ++i) {
+        int server_id = ctx->chosen_servers[i];
+        ServerSendState* st = &ctx->server_states[server_id];
+        const VMS_MessageToSend_t* msg = st->choice;
+        bool same_msg = !message_list->resend_all && st->won_frame + 1 == frame &&
+                        st->won_template_id == msg->message_template_id && st->won_group_id == st->choice_group_id;
+        st->choice = NULL;
+        st->won_frame = frame;
+        st->won_template_id = msg->message_template_id;
+        st->won_group_id = st->choice_group_id;
+        if (same_msg) {
+            printf("[Sender]   SAME: %s:%d 직전 프레임과 같은 메시지 (그룹 %d).\n",
+                   topology->servers[server_id]->ip_address, topology->servers[server_id]->port, st->won_group_id);
+            continue;
+        }
+        if (vms_servers->sender) send_packet_to_server(topology->servers[server_id], msg->packet);
+    }
+    vms_manager_leave(ctx->topology_reader);
+    free_vms_message_list(message_list);
+}
+
+// --- 파이프라인 스테이지 (파이프라인 모드에서 각각 전용 스레드로 실행) ---
+
+static void* parse_stage(void* item, void* user_data) {
+    FrameItem* frame = (FrameItem*)item;
+    (void)user_data;
+    SdsJson_MainMessage_t* parsed_message = sds_json_parse_message_len(frame->data, frame->len);
+    free(frame);
+    return parsed_message;
+}
+
+static void* decide_stage(void* item, void* user_data) {
+    return decide_outbound_messages((ReaderContext*)user_data, (SdsJson_MainMessage_t*)item);
+}
+
+static void* send_stage(void* item, void* user_data) {
+    send_outbound_messages((ReaderContext*)user_data, (VMS_MessageList_t*)item);
+    return NULL;
+}
+
+// SDSM 프레임 하나를 처리한다.
+// 파이프라인 모드에서는 프레임을 복사해 parse 스테이지로 넘기고 바로 반환한다.
+static void dispatch_sdsm_frame(ReaderContext* ctx, const char* json_string, size_t json_len) {
+    if (ctx->pipeline) {
+        FrameItem* frame = (FrameItem*)malloc(sizeof(FrameItem) + json_len + 1);
+        if (!frame) {
+            perror("Failed to allocate FrameItem");
+            return;
+        }
+        frame->len = json_len;
+        memcpy(frame->data, json_string, json_len + 1); // 널 문자까지 복사
+        pipeline_submit(ctx->pipeline, frame);
+        return;
+    }
+
+    SdsJson_MainMessage_t* parsed_message = sds_json_parse_message_len(json_string, json_len);
+    if (!parsed_message) return;
+
+    VMS_MessageList_t* message_list = decide_outbound_messages(ctx, parsed_message);
+    if (message_list) send_outbound_messages(ctx, message_list);
+}
+
+// 완성된 SDSM 프레임마다 호출되는 수신 콜백
+// 최신 프레임 우선 모드에서는 헤더만 보고 후보로 보관하며, 처리는 poll 회차가 끝난 뒤에 한다.
+static void process_sdsm_frame(char* json_string, size_t json_len, const IngestConnection* conn, void* user_data) {
+    ReaderContext* ctx = (ReaderContext*)user_data;
+    (void)conn;
+
+    if (ctx->coalescer) {
+        sds_coalescer_offer(ctx->coalescer, json_string, json_len);
+        return;
+    }
+    dispatch_sdsm_frame(ctx, json_string, json_len);
+}
+
+// poll 회차 동안 보관된 가장 새로운 프레임을 처리
+static void flush_coalesced_frame(ReaderContext* ctx) {
+    const char* json_string;
+    size_t json_len;
+    if (ctx->coalescer && sds_coalescer_take(ctx->coalescer, &json_string, &json_len)) {
+        dispatch_sdsm_frame(ctx, json_string, json_len);
+    }
+}
+
+static void report_coalescer(const SdsCoalescer* coalescer) {
+    if (!coalescer) return;
+    const SdsCoalescerCounters* c = &coalescer->counters;
+    printf("[Coalesce] accepted=%lu superseded=%lu stale=%lu duplicate=%lu invalid=%lu resyncs=%lu\n",
+           c->accepted, c->superseded, c->stale, c->duplicate, c->invalid, c->resyncs);
 }
 
 int main (int argc, char** argv)
@@ -245,212 +340,145 @@ int main (int argc, char** argv)
         fprintf(stderr, "VMS 매니저 초기화 실패. 프로그램 종료\n");
         return 1;
     }
-    printf("VMS 매니저 초기화 성공. 총 설정된 서버 수: %d, 그룹 수: %d\n",
-           vms_servers->total_servers_configured, vms_servers->num_groups);
+    const VMSTopology* topology = vms_manager_topology(vms_servers);
+    printf("VMS 매니저 초기화 성공. 총 설정된 서버 수: %d (중복 제외 %d), 그룹 수: %d\n",
+           topology->total_servers_configured, topology->num_servers, topology->num_groups);
+
+    // config.ini와 시나리오를 읽어 첫 설정 스냅샷을 만든다 (이후 파일이 바뀌면 리로드 스레드가 새 스냅샷으로 교체)
+    ConfigReloader* reloader = config_reloader_create("config.ini", "scenario2.CSV");
+    if (!reloader) {
+        fprintf(stderr, "Config.ini 또는 Scenario CSV 로드 실패. 프로그램 종료\n");
+        vms_manager_cleanup(vms_servers);
+        return 1;
+    }
+    // 시작할 때만 쓰는 값 (리스닝 주소, 큐 크기 등)은 첫 스냅샷에서 복사해 둔다
+    VMS_TextParamConfig_t config = config_reloader_initial(reloader)->config;
 
-    VMS_TextParamConfig_t config;
-    if (!vms_controller_load_config("config.ini", &config)) {
-        fprintf(stderr, "Config.ini 로드 실패. 프로그램 종료\n");
+    printf("listen IP: %s.%d\n", config.listen_ip, config.listen_port);
+    int listen_fd = setup_listening_socket(config.listen_port, config.listen_ip);
+    if (listen_fd < 0) {
+        config_reloader_destroy(reloader);
         vms_manager_cleanup(vms_servers);
         return 1;
     }
 
-    VMS_ScenarioList_t* scenario_list = load_scenarios_from_csv("scenario2.CSV");
-    if (!scenario_list) {
-        fprintf(stderr, "Scenario CSV 로드 실패. 프로그램 종료\n");
+    // 다중 송신측 수신 서버 (리스닝 소켓은 ingest_server_destroy에서 닫힘)
+    IngestServer* ingest_server = ingest_server_create(listen_fd, config.max_ingest_connections,
+                                                       (size_t)config.ingest_read_budget, RCV_BUF_SIZE,
+                                                       ingest_drain_policy_from_string(config.drain_policy),
+                                                       config.drain_max_frames);
+    if (!ingest_server) {
+        fprintf(stderr, "수신 서버 생성 실패. 프로그램 종료\n");
+        close(listen_fd);
+        config_reloader_destroy(reloader);
         vms_manager_cleanup(vms_servers);
         return 1;
     }
 
-    printf("listen IP: %s.%d\n", config.listen_ip, config.listen_port);
-    int listen_fd = setup_listening_socket(config.listen_port, config.listen_ip);
-    if (listen_fd < 0) {
-        free_scenario_list(scenario_list);
+    // 송신 스레드와 서버별 송신 큐 (연결 관리자가 연결된 소켓을 큐에 붙인다)
+    if (!vms_manager_start_sender(vms_servers, config.send_queue_depth, config.send_latest_only)) {
+        fprintf(stderr, "송신 스레드 시작 실패. 프로그램 종료\n");
+        ingest_server_destroy(ingest_server);
+        config_reloader_destroy(reloader);
         vms_manager_cleanup(vms_servers);
         return 1;
     }
 
+    if (config.connect_timeout_ms > 0) vms_servers->connect_timeout_ms = config.connect_timeout_ms;
+    vms_servers->hot_reload = config.hot_reload; // vms_servers.ini도 config.ini와 같은 설정으로 다시 읽는다
+    if (config.reload_settle_ms > 0) vms_servers->reload_settle_ms = config.reload_settle_ms;
+
     // 연결 관리자 스레드 생성
     if (pthread_create(&conn_manager_tid, NULL, connection_manager_thread_func, vms_servers) != 0) {
         perror("VMSconnection_manager 스레스 생성 실패. 프로그램 종료\n");
-        close(listen_fd);
-        free_scenario_list(scenario_list);
+        ingest_server_destroy(ingest_server);
+        config_reloader_destroy(reloader);
         vms_manager_cleanup(vms_servers); // 뮤텍스도 여기서 destroy됨
         return 1;
     }
 
     sleep(1);   // 연결 대기를 위한 1초
 
-    fd_set all_fds;
-    int client_fd = -1;
-    char recv_buffer[RCV_BUF_SIZE] = {0};
+    ReaderContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.vms_servers = vms_servers;
+    ctx.reloader = reloader;
+    ctx.config_reader = config_reloader_register_reader(reloader); // 결정 상태는 첫 프레임에서 스냅샷으로 만든다
+    ctx.topology_reader = vms_manager_register_reader(vms_servers);
+    if (!ctx.config_reader || !ctx.topology_reader) { // 서버별 전송 테이블은 첫 프레임에서 서버 구성에 맞춰 만든다
+        fprintf(stderr, "설정/서버 구성을 읽는 스레드 등록 실패. 프로그램 종료\n");
+        keep_running_manager = 0;
+    }
 
-    // 직전 프레임의 최종 메시지 목록을 저장할 포인터
-    WinningMessageList* prev_winning_list = (WinningMessageList*)calloc(1, sizeof(WinningMessageList));
+    sds_json_set_parser(sds_json_parser_from_string(config.json_parser));
+    sds_json_set_lazy_waypoints(config.lazy_waypoints);
+    sds_json_use_arena(config.parse_arena);
 
-    while (keep_running_manager) {
-        FD_ZERO(&all_fds);
-        FD_SET(listen_fd, &all_fds);
-        int max_fd = listen_fd;
+    if (config.coalesce_frames && keep_running_manager) {
+        ctx.coalescer = sds_coalescer_create(RCV_BUF_SIZE);
+        if (!ctx.coalescer) fprintf(stderr, "최신 프레임 우선 모드 시작 실패. 모든 프레임을 처리\n");
+    }
 
-        if (client_fd != -1) {
-            FD_SET(client_fd, &all_fds);
-            if (client_fd > max_fd) max_fd = client_fd;
+    // 파이프라인 모드: recv(메인 스레드) -> parse -> decide -> send 를 각각 전용 스레드로 분리
+    if (config.pipeline_enabled && keep_running_manager) {
+        PipelineStageDesc stages[] = {
+            { "parse",  parse_stage,  free,                     &ctx },
+            { "decide", decide_stage, free_parsed_message_item, &ctx },
+            { "send",   send_stage,   free_message_list_item,   &ctx },
+        };
+        ctx.pipeline = pipeline_create(stages, 3, (size_t)config.pipeline_queue_depth,
+                                       ring_queue_policy_from_string(config.pipeline_overflow_policy));
+        if (!ctx.pipeline || !pipeline_start(ctx.pipeline)) {
+            fprintf(stderr, "파이프라인 시작 실패. 단일 스레드 모드로 동작\n");
+            pipeline_destroy(ctx.pipeline);
+            ctx.pipeline = NULL;
         }
+    }
 
-        struct timeval timeout = { .tv_sec = 1, .tv_usec = 0 };
-        int activity = select(max_fd + 1, &all_fds, NULL, NULL, &timeout);
+    if (config.hot_reload && keep_running_manager && !config_reloader_start(reloader, config.reload_settle_ms)) {
+        fprintf(stderr, "설정 핫 리로드 시작 실패. 시작할 때 읽은 설정으로 동작\n");
+    }
 
-        if (activity < 0 && errno != EINTR) {
-            perror("select() error");
+    while (keep_running_manager) {
+        if (ingest_server_poll(ingest_server, 1000, process_sdsm_frame, &ctx) < 0) {
             break;
         }
-        if (activity == 0) continue;
-
-        if (FD_ISSET(listen_fd, &all_fds)) {
-            struct sockaddr_in client_addr;
-            socklen_t client_len = sizeof(client_addr);
-            int new_socket = accept(listen_fd, (struct sockaddr*)&client_addr, &client_len);
-
-            if (new_socket >= 0) {
-                printf("[TCPServer] New connection accepted from %s:%d (fd: %d)\n",
-                       inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port), new_socket);
-                if (client_fd != -1) {
-                    printf("[TCPServer] Closing previous connection (fd: %d).\n", client_fd);
-                    close(client_fd);
-                }
-                client_fd = new_socket;
-            } else {
-                perror("accept failed");
-            }
+        flush_coalesced_frame(&ctx);
+        if (config.ingest_stats_interval > 0 &&
+            ingest_server_report(ingest_server, config.ingest_stats_interval * 1000)) {
+            report_coalescer(ctx.coalescer);
+            vms_manager_report_queues(vms_servers);
+            config_reloader_report(reloader, 0);
         }
-
-        if (client_fd != -1 && FD_ISSET(client_fd, &all_fds)) {
-            char temp_buf[RCV_BUF_SIZE/2];
-            ssize_t bytes_read = recv(client_fd, temp_buf, sizeof(temp_buf) - 1, 0);
-
-            if (bytes_read > 0) {
-                temp_buf[bytes_read] = '\0';
-                if (strlen(recv_buffer) + bytes_read < sizeof(recv_buffer)) {
-                    strcat(recv_buffer, temp_buf);
-                } else {
-                     fprintf(stderr, "Receive buffer overflow! Discarding data.\n");
-                     recv_buffer[0] = '\0'; // 버퍼 비움
-                }
-
-                char* json_string;
-                int innertimer=0;
-                while ((json_string = extract_json_message(recv_buffer)) != NULL) {
-                    if (innertimer++ >= 10) {
-                        printf("[MainLoop] 내부 루프문 오류");
-                        break; // or continue
-                    }
-                    SdsJson_MainMessage_t* parsed_message = sds_json_parse_message(json_string);
-                    if (parsed_message) {
-                        VMS_HostObjectState_List_t* state_list = vms_controller_process_json_to_state(parsed_message, &config);
-                        WinningMessageList* winning_list = (WinningMessageList*)calloc(1, sizeof(WinningMessageList));
-                        
-                        if (state_list && winning_list) {
-                            for (int i = 0; i < state_list->count; ++i) {
-                                VMS_HostObjectState_t* obj_state = &state_list->hostobjects[i];
-                                const SdsJson_ApproachTrafficInfoData_t* original_ati = &parsed_message->approach_traffic_info_list[i];
-
-                                for (int j = 0; j < scenario_list->count; ++j) {
-                                    VMS_ScenarioRule_t* rule = &scenario_list->rules[j];
-                                    
-                                    int rule_entry_dir = (rule->entry_direction_code > 0) ? config.direction_codes[rule->entry_direction_code - 1] : 0;
-                                    int rule_egress_dir = (rule->egress_direction_code > 0) ? config.direction_codes[rule->egress_direction_code - 1] : 0;
-                                    int rule_conflict_dir = (rule->conflict_direction_code > 0) ? config.direction_codes[rule->conflict_direction_code - 1] : 0;
-
-                                    bool entry_match = (rule_entry_dir == obj_state->entry_direction_code);
-                                    bool egress_match = (rule_egress_dir == obj_state->egress_direction_code);
-                                    bool conflict_match = (obj_state->has_conflict ? (rule_conflict_dir == obj_state->remote_obj_direction_code) : (rule_conflict_dir == 0));
-
-                                    if (entry_match && egress_match && conflict_match) {
-                                        int groups[4] = { config.direction_codes[0], config.direction_codes[1], config.direction_codes[2], config.direction_codes[3] };
-                                        int group_msgs1[4] = { rule->A1, rule->B1, rule->C1, rule->D1 };
-                                        int group_msgs2[4] = { rule->A2, rule->B2, rule->C2, rule->D2 };
-                                        int group_msgs3[4] = { rule->A3, rule->B3, rule->C3, rule->D3 };
-                                        
-                                        for (int k = 0; k < 4; ++k) {
-                                            if (group_msgs1[k] >= 0) { upsert_winning_message(winning_list, groups[k], group_msgs1[k], original_ati); }
-                                            if (group_msgs2[k] >= 0) { upsert_winning_message(winning_list, groups[k] + 1000, group_msgs2[k], original_ati); }
-                                            if (group_msgs3[k] >= 0) { upsert_winning_message(winning_list, groups[k] + 2000, group_msgs3[k], original_ati); }
-                                        }
-                                    }
-                                }
-                            }
-                            printf("\n--- Final Messages to Send (MsgCount: %d) ---\n", parsed_message->msg_count);
-                            for (int i = 0; i < winning_list->count; ++i) {
-                                WinningMessage* msg = &winning_list->messages[i];
-                                bool send_this_message = true;
-                                for (int j = 0; j < prev_winning_list->count; ++j) {
-                                    WinningMessage* prev_msg = &prev_winning_list->messages[j];
-                                    if (msg->group_id == prev_msg->group_id) {
-                                        if (msg->message_template_id == prev_msg->message_template_id) {
-                                            send_this_message = false;
-                                        }
-                                        break;
-                                    }
-                                }
-                                if (send_this_message == true) {
-                                    char payload_buffer[1024];
-                                    char final_text[512];
-                                    const char* templates[5] = { config.msg_template0, config.msg_template1, config.msg_template2, config.msg_template3, config.msg_template4 };
-
-                                    if (msg->message_template_id >= 0 && msg->message_template_id < 5) {
-                                        const char* template = templates[msg->message_template_id];
-                                        if (msg->message_template_id == 1 || msg->message_template_id == 3) {
-                                            snprintf(final_text, sizeof(final_text), template, msg->dir_code, msg->speed);
-                                        } else if (msg->message_template_id == 4) {
-                                            snprintf(final_text, sizeof(final_text), template, msg->pet);
-                                        } else {
-                                            snprintf(final_text, sizeof(final_text), "%s", template);
-                                        }
-                                        snprintf(payload_buffer, sizeof(payload_buffer), "RST=%s,SPD=%s,TXT=%s%s%s",
-                                                config.rst, config.spd, config.default_font, config.default_color, final_text);
-                                        uint16_t packet_len = 0;
-                                        uint8_t* packet_data = create_text_control_packet(CMD_TYPE_INSERT, payload_buffer, &packet_len);
-                                        if (packet_data && packet_len > 0) {
-                                            printf("  ==> Sending to Group %d: %s\n", msg->group_id, payload_buffer);
-                                            send_message_to_group_thread_safe(vms_servers, msg->group_id, (const char*)packet_data, packet_len);
-                                            free(packet_data);
-                                        }
-                                    }
-                                } else {
-                                    printf("  ==> Skip Group (Same msg) %d\n", msg->group_id);
-                                }
-                            }
-                            free_winning_message_list(prev_winning_list);
-                            prev_winning_list = winning_list;
-                        }
-                        if (state_list) free_vms_object_state_list(state_list);
-                        free_sds_json_main_message(parsed_message);
-                        usleep(10000);
-                    }
-                    free(json_string);
-                }
-            } else {
-                printf("[TCPServer] Client disconnected (fd: %d).\n", client_fd);
-                close(client_fd);
-                client_fd = -1;
-                recv_buffer[0] = '\0';
-            }
+        if (ctx.pipeline && config.pipeline_report_interval > 0) {
+            pipeline_report(ctx.pipeline, config.pipeline_report_interval * 1000);
         }
     }
 
     printf("Main loop finished. Shutting down...\n");
     keep_running_manager = 0;
-    
-    if (client_fd != -1) close(client_fd);
-    close(listen_fd);
-    
+
+    ingest_server_report(ingest_server, 0);
+    report_coalescer(ctx.coalescer);
+    ingest_server_destroy(ingest_server);
+    if (ctx.pipeline) {
+        pipeline_report(ctx.pipeline, 0);
+        pipeline_destroy(ctx.pipeline); // 이미 받은 프레임은 모두 처리한 뒤 종료
+    }
+    vms_manager_report_queues(vms_servers);
+    config_reloader_report(reloader, 0);
+
     if (pthread_join(conn_manager_tid, NULL) != 0) { perror("Failed to join connection manager thread"); }
     else { printf("Connection manager thread joined successfully.\n"); }
 
-    free_winning_message_list(prev_winning_list);
-    free_scenario_list(scenario_list);
+    sds_coalescer_destroy(ctx.coalescer);
+    sds_json_use_arena(false); // 파싱된 메시지가 모두 해제된 뒤에 (파이프라인 종료 후)
+    vms_controller_release_pools();
+    free(ctx.server_states);
+    free(ctx.chosen_servers);
+    config_reloader_destroy(reloader); // decide 스테이지가 끝난 뒤에 (파이프라인 종료 후)
     vms_manager_cleanup(vms_servers);
+    vms_packet_buffer_pool_release(); // 송신 큐가 잡고 있던 패킷까지 반환된 뒤에
     printf("All tasks completed. Exiting.\n");
     
     return 0;
@@ -0,0 +1,213 @@
+// ring_queue.c
+
+#include "ring_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>    // for strcasecmp
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+static long futex_wait(atomic_uint* addr, unsigned int expected, const struct timespec* timeout) {
+    return syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+}
+
+static void futex_wake_all(atomic_uint* addr) {
+    syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static int64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void release_item(RingQueue* q, void* item) {
+    if (item && q->free_fn) q->free_fn(item);
+}
+
+// 항목을 꺼낸 뒤 대기 중인 생산자를 깨움
+static void notify_pop(RingQueue* q) {
+    atomic_fetch_add(&q->pop_seq, 1);
+    if (atomic_load(&q->producer_waiting)) {
+        futex_wake_all(&q->pop_seq);
+    }
+}
+
+RingQueue* ring_queue_create(size_t min_capacity, RingQueuePolicy policy, RingQueueFreeFn free_fn) {
+    RingQueue* q = (RingQueue*)calloc(1, sizeof(RingQueue));
+    if (!q) {
+        perror("Failed to allocate RingQueue");
+        return NULL;
+    }
+
+    size_t capacity = 2;
+    while (capacity < min_capacity) capacity <<= 1;
+
+    q->slots = (_Atomic(void*)*)calloc(capacity, sizeof(*q->slots));
+    if (!q->slots) {
+        perror("Failed to allocate RingQueue slots");
+        free(q);
+        return NULL;
+    }
+    q->capacity = capacity;
+    q->mask = capacity - 1;
+    q->policy = policy;
+    q->free_fn = free_fn;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->push_seq, 0);
+    atomic_init(&q->pop_seq, 0);
+    atomic_init(&q->consumer_waiting, 0);
+    atomic_init(&q->producer_waiting, 0);
+    atomic_init(&q->closed, false);
+    atomic_init(&q->pushed, 0);
+    atomic_init(&q->popped, 0);
+    atomic_init(&q->dropped, 0);
+    atomic_init(&q->high_watermark, 0);
+    return q;
+}
+
+void ring_queue_destroy(RingQueue* q) {
+    if (!q) return;
+    void* item;
+    while ((item = ring_queue_pop(q, 0)) != NULL) {
+        release_item(q, item);
+    }
+    free(q->slots);
+    free(q);
+}
+
+bool ring_queue_push(RingQueue* q, void* item) {
+    if (!q || !item) return false;
+
+    while (1) {
+        if (atomic_load_explicit(&q->closed, memory_order_acquire)) {
+            release_item(q, item);
+            return false;
+        }
+
+        size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+        if (tail - head < q->capacity) {
+            atomic_store_explicit(&q->slots[tail & q->mask], item, memory_order_relaxed);
+            atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+
+            atomic_fetch_add_explicit(&q->pushed, 1, memory_order_relaxed);
+            size_t depth = tail + 1 - head;
+            if (depth > atomic_load_explicit(&q->high_watermark, memory_order_relaxed)) {
+                atomic_store_explicit(&q->high_watermark, depth, memory_order_relaxed);
+            }
+
+            atomic_fetch_add(&q->push_seq, 1);
+            if (atomic_load(&q->consumer_waiting)) {
+                futex_wake_all(&q->push_seq);
+            }
+            return true;
+        }
+
+        // 큐가 가득 참
+        if (q->policy == RING_QUEUE_DROP_NEWEST) {
+            atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+            release_item(q, item);
+            return false;
+        }
+
+        if (q->policy == RING_QUEUE_DROP_OLDEST) {
+            // 소비자와 같은 방식(CAS)으로 head를 전진시켜 가장 오래된 항목의 소유권을 가져온다
+            void* oldest = atomic_load_explicit(&q->slots[head & q->mask], memory_order_relaxed);
+            if (atomic_compare_exchange_strong_explicit(&q->head, &head, head + 1,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+                release_item(q, oldest);
+            }
+            continue;
+        }
+
+        // RING_QUEUE_BLOCK: 소비자가 항목을 꺼낼 때까지 대기
+        unsigned int seq = atomic_load(&q->pop_seq);
+        atomic_store(&q->producer_waiting, 1);
+        if (atomic_load(&q->tail) - atomic_load(&q->head) >= q->capacity && !atomic_load(&q->closed)) {
+            futex_wait(&q->pop_seq, seq, NULL);
+        }
+        atomic_store(&q->producer_waiting, 0);
+    }
+}
+
+void* ring_queue_pop(RingQueue* q, int timeout_ms) {
+    if (!q) return NULL;
+    int64_t deadline = (timeout_ms > 0) ? monotonic_ms() + timeout_ms : 0;
+
+    while (1) {
+        size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+        size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+        if (head != tail) {
+            void* item = atomic_load_explicit(&q->slots[head & q->mask], memory_order_relaxed);
+            // DROP_OLDEST 정책에서는 생산자가 같은 항목을 먼저 가져갈 수 있으므로 CAS로 확정
+            if (atomic_compare_exchange_strong_explicit(&q->head, &head, head + 1,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                atomic_fetch_add_explicit(&q->popped, 1, memory_order_relaxed);
+                notify_pop(q);
+                return item;
+            }
+            continue;
+        }
+
+        if (atomic_load(&q->closed) || timeout_ms == 0) return NULL;
+
+        struct timespec ts;
+        struct timespec* ts_ptr = NULL;
+        if (timeout_ms > 0) {
+            int64_t remaining = deadline - monotonic_ms();
+            if (remaining <= 0) return NULL;
+            ts.tv_sec = remaining / 1000;
+            ts.tv_nsec = (remaining % 1000) * 1000000;
+            ts_ptr = &ts;
+        }
+
+        unsigned int seq = atomic_load(&q->push_seq);
+        atomic_store(&q->consumer_waiting, 1);
+        if (atomic_load(&q->head) == atomic_load(&q->tail) && !atomic_load(&q->closed)) {
+            futex_wait(&q->push_seq, seq, ts_ptr);
+        }
+        atomic_store(&q->consumer_waiting, 0);
+    }
+}
+
+void ring_queue_close(RingQueue* q) {
+    if (!q) return;
+    atomic_store(&q->closed, true);
+    atomic_fetch_add(&q->push_seq, 1);
+    atomic_fetch_add(&q->pop_seq, 1);
+    futex_wake_all(&q->push_seq);
+    futex_wake_all(&q->pop_seq);
+}
+
+size_t ring_queue_size(RingQueue* q) {
+    if (!q) return 0;
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return tail - head;
+}
+
+RingQueuePolicy ring_queue_policy_from_string(const char* str) {
+    if (str) {
+        if (strcasecmp(str, "drop_newest") == 0) return RING_QUEUE_DROP_NEWEST;
+        if (strcasecmp(str, "drop_oldest") == 0) return RING_QUEUE_DROP_OLDEST;
+    }
+    return RING_QUEUE_BLOCK;
+}
+
+const char* ring_queue_policy_name(RingQueuePolicy policy) {
+    switch (policy) {
+        case RING_QUEUE_DROP_NEWEST: return "drop_newest";
+        case RING_QUEUE_DROP_OLDEST: return "drop_oldest";
+        default: return "block";
+    }
+}
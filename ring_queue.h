@@ -0,0 +1,89 @@
+// ring_queue.h
+
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// 큐가 가득 찼을 때의 처리 정책
+typedef enum {
+    RING_QUEUE_BLOCK = 0,       // 빈 자리가 생길 때까지 생산자 대기
+    RING_QUEUE_DROP_NEWEST,     // 새로 넣으려는 항목을 버림
+    RING_QUEUE_DROP_OLDEST      // 가장 오래된 항목을 버리고 새 항목을 넣음
+} RingQueuePolicy;
+
+// 큐 항목을 버릴 때 호출되는 해제 함수
+typedef void (*RingQueueFreeFn)(void* item);
+
+// 생산자 1개, 소비자 1개용 고정 크기 lock-free 링 큐 (void* 항목)
+// 빈 큐/가득 찬 큐에서의 대기는 futex로 처리하므로 유휴 시 CPU를 쓰지 않는다.
+typedef struct {
+    _Atomic(void*)* slots;
+    size_t capacity;             // 2의 거듭제곱
+    size_t mask;
+    _Alignas(64) atomic_size_t head;   // 소비자가 꺼낼 위치 (DROP_OLDEST 시 생산자도 CAS로 전진)
+    _Alignas(64) atomic_size_t tail;   // 생산자가 넣을 위치
+    _Alignas(64) atomic_uint push_seq; // 항목 추가 시 증가 (소비자 futex 대기용)
+    atomic_uint pop_seq;               // 항목 제거 시 증가 (생산자 futex 대기용)
+    atomic_int consumer_waiting;
+    atomic_int producer_waiting;
+    atomic_bool closed;
+    RingQueuePolicy policy;
+    RingQueueFreeFn free_fn;     // 버려진 항목 해제 함수 (NULL 가능)
+
+    // 통계 (다른 스레드에서 읽을 수 있도록 atomic)
+    atomic_ulong pushed;
+    atomic_ulong popped;
+    atomic_ulong dropped;
+    atomic_size_t high_watermark;
+} RingQueue;
+
+/**
+ * @brief 링 큐를 생성합니다.
+ * @param min_capacity 최소 크기. 2의 거듭제곱으로 올림됩니다.
+ * @param policy 가득 찼을 때의 처리 정책.
+ * @param free_fn 정책에 의해 버려지거나 파괴 시 남아 있는 항목을 해제할 함수 (NULL 가능).
+ * @return 성공 시 RingQueue 포인터, 실패 시 NULL.
+ */
+RingQueue* ring_queue_create(size_t min_capacity, RingQueuePolicy policy, RingQueueFreeFn free_fn);
+
+/**
+ * @brief 큐를 해제합니다. 남아 있는 항목은 free_fn으로 해제합니다.
+ */
+void ring_queue_destroy(RingQueue* q);
+
+/**
+ * @brief 항목을 넣습니다. (생산자 스레드 전용)
+ * @return 항목이 큐에 들어갔으면 true. DROP_NEWEST로 버려졌거나 큐가 닫혔으면 false
+ * (이때 항목은 free_fn으로 해제됨).
+ */
+bool ring_queue_push(RingQueue* q, void* item);
+
+/**
+ * @brief 항목을 꺼냅니다. (소비자 스레드 전용)
+ * @param timeout_ms 비어 있을 때 대기할 시간. 0이면 대기하지 않음, 음수면 무한 대기.
+ * @return 꺼낸 항목, 비어 있거나 큐가 닫혔으면 NULL.
+ */
+void* ring_queue_pop(RingQueue* q, int timeout_ms);
+
+/**
+ * @brief 큐를 닫고 대기 중인 생산자/소비자를 깨웁니다.
+ */
+void ring_queue_close(RingQueue* q);
+
+/**
+ * @brief 현재 큐에 들어 있는 항목 수.
+ */
+size_t ring_queue_size(RingQueue* q);
+
+/**
+ * @brief "block", "drop_newest", "drop_oldest" 문자열을 정책 값으로 변환합니다. 알 수 없으면 RING_QUEUE_BLOCK.
+ */
+RingQueuePolicy ring_queue_policy_from_string(const char* str);
+
+const char* ring_queue_policy_name(RingQueuePolicy policy);
+
+#endif // RING_QUEUE_H
@@ -4,6 +4,47 @@
 #include <string.h>
 #include <errno.h>
 
+// 규칙의 방향 코드를 테이블 인덱스로 변환. 0 이하는 해당없음(0)과 같이 취급한다.
+static int scenario_code_index(int code) {
+    if (code <= 0) return 0;
+    if (code >= SCENARIO_NUM_DIRECTION_CODES) return -1;
+    return code;
+}
+
+// 규칙 하나를 결정 테이블에 넣는다. 이미 같은 조합이 있으면 그룹별로 큰 메시지 번호를 남긴다.
+static bool add_rule_to_table(VMS_ScenarioList_t* list, const VMS_ScenarioRule_t* r) {
+    int entry = scenario_code_index(r->entry_direction_code);
+    int egress = scenario_code_index(r->egress_direction_code);
+    int conflict = scenario_code_index(r->conflict_direction_code);
+    if (entry < 0 || egress < 0 || conflict < 0) {
+        fprintf(stderr, "Warning: Scenario rule %d has a direction code out of range (0~%d). Rule ignored.\n",
+                r->event_id, SCENARIO_NUM_DIRECTION_CODES - 1);
+        return false;
+    }
+
+    const int msgs[SCENARIO_NUM_GROUPS][SCENARIO_NUM_GROUP_LAYERS] = {
+        { r->A1, r->A2, r->A3 }, { r->B1, r->B2, r->B3 }, { r->C1, r->C2, r->C3 }, { r->D1, r->D2, r->D3 }
+    };
+    VMS_ScenarioCell_t* cell = &list->table[entry][egress][conflict];
+
+    if (!cell->valid) {
+        cell->valid = true;
+        cell->event_id = r->event_id;
+        memcpy(cell->msgs, msgs, sizeof(cell->msgs));
+        return true;
+    }
+
+    fprintf(stderr, "Warning: Scenario rule %d overlaps rule %d (entry %d, egress %d, conflict %d). Merged by highest message id.\n",
+            r->event_id, cell->event_id, entry, egress, conflict);
+    list->duplicate_rules++;
+    for (int g = 0; g < SCENARIO_NUM_GROUPS; ++g) {
+        for (int l = 0; l < SCENARIO_NUM_GROUP_LAYERS; ++l) {
+            if (msgs[g][l] > cell->msgs[g][l]) cell->msgs[g][l] = msgs[g][l];
+        }
+    }
+    return true;
+}
+
 VMS_ScenarioList_t* load_scenarios_from_csv(const char* csv_filepath) {
     FILE* file = fopen(csv_filepath, "r");
     if (!file) {
@@ -55,14 +96,26 @@ VMS_ScenarioList_t* load_scenarios_from_csv(const char* csv_filepath) {
         if (items < 16) { // 16개 필드가 모두 있어야 함
             fprintf(stderr, "Warning: Skipping malformed line in scenario.csv: %s\n", line);
             list->count--; // 잘못된 라인은 카운트에서 제외하고, realloc된 메모리는 그대로 둠
+        } else if (!add_rule_to_table(list, r)) {
+            list->count--;
         }
     }
 
     fclose(file);
-    printf("[ScenarioManager] Loaded %d rules from %s\n", list->count, csv_filepath);
+    printf("[ScenarioManager] Loaded %d rules from %s", list->count, csv_filepath);
+    if (list->duplicate_rules > 0) printf(" (%d overlapping rules merged)", list->duplicate_rules);
+    printf("\n");
     return list;
 }
 
+unsigned int scenario_direction_mask(const int direction_codes[SCENARIO_NUM_GROUPS], int direction) {
+    unsigned int mask = (direction == 0) ? 1u : 0u;
+    for (int k = 0; k < SCENARIO_NUM_GROUPS; ++k) {
+        if (direction_codes[k] == direction) mask |= 1u << (k + 1);
+    }
+    return mask;
+}
+
 void free_scenario_list(VMS_ScenarioList_t* list) {
     if (!list) return;
     if (list->rules) {
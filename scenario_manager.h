@@ -1,7 +1,13 @@
 #ifndef SCENARIO_MANAGER_H
 #define SCENARIO_MANAGER_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #define MAX_SCENARIO_MSG_LEN 256
+#define SCENARIO_NUM_DIRECTION_CODES 5  // 방향 코드 0(해당없음) ~ 4(DirCode4)
+#define SCENARIO_NUM_GROUPS 4           // A, B, C, D
+#define SCENARIO_NUM_GROUP_LAYERS 3     // 그룹 번호, +1000, +2000
 
 // scenario.csv의 한 행에 해당하는 규칙 구조체
 typedef struct {
@@ -23,14 +29,45 @@ typedef struct {
     int D3;
 } VMS_ScenarioRule_t;
 
+// (진입, 진출, 상충) 방향 코드 조합 하나에 대해 미리 계산한 그룹별 메시지 번호
+typedef struct {
+    bool valid;                     // 이 조합에 해당하는 규칙이 있으면 true
+    int event_id;                   // 처음 정의한 규칙의 event_id (로그용)
+    int msgs[SCENARIO_NUM_GROUPS][SCENARIO_NUM_GROUP_LAYERS]; // [A~D][1~3], 음수이면 해당 그룹 메시지 없음
+} VMS_ScenarioCell_t;
+
 // 시나리오 규칙들의 리스트
 typedef struct {
     VMS_ScenarioRule_t* rules;
     int count;
+    // 규칙을 방향 코드로 바로 찾기 위한 결정 테이블 [진입][진출][상충]
+    // 같은 조합에 규칙이 여럿이면 그룹별로 큰 메시지 번호를 남긴다 (upsert와 동일한 결과)
+    VMS_ScenarioCell_t table[SCENARIO_NUM_DIRECTION_CODES][SCENARIO_NUM_DIRECTION_CODES][SCENARIO_NUM_DIRECTION_CODES];
+    int duplicate_rules;            // 다른 규칙과 조합이 겹쳐 합쳐진 규칙 수
 } VMS_ScenarioList_t;
 
+/**
+ * @brief 시나리오 CSV를 읽고 (진입, 진출, 상충) 결정 테이블을 만듭니다.
+ * 같은 조합이 여러 행에 정의되어 있으면 경고를 출력하고 하나의 칸으로 합칩니다.
+ * @return 성공 시 VMS_ScenarioList_t 포인터 (free_scenario_list로 해제), 실패 시 NULL.
+ */
 VMS_ScenarioList_t* load_scenarios_from_csv(const char* csv_filepath);
 
+/**
+ * @brief 방향 코드(degree)가 어떤 시나리오 방향 코드(0~4)에 해당하는지 비트마스크로 반환합니다.
+ * 비트 0은 0(해당없음), 비트 k는 direction_codes[k-1]과 같은 경우입니다.
+ * DirCode 설정이 서로 다르면 최대 한 비트만 켜집니다.
+ */
+unsigned int scenario_direction_mask(const int direction_codes[SCENARIO_NUM_GROUPS], int direction);
+
+/**
+ * @brief 시나리오 방향 코드(0~4) 조합에 해당하는 결정 테이블 칸을 반환합니다. 규칙이 없으면 NULL.
+ */
+static inline const VMS_ScenarioCell_t* scenario_lookup(const VMS_ScenarioList_t* list, int entry, int egress, int conflict) {
+    const VMS_ScenarioCell_t* cell = &list->table[entry][egress][conflict];
+    return cell->valid ? cell : NULL;
+}
+
 void free_scenario_list(VMS_ScenarioList_t* list);
 
 #endif // SCENARIO_MANAGER_H
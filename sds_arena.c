@@ -0,0 +1,235 @@
+// sds_arena.c
+
+#include "sds_arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define SDS_ARENA_ALIGN 16
+
+static __thread SdsArena* t_active_arena = NULL;
+
+static size_t align_up(size_t size) {
+    return (size + SDS_ARENA_ALIGN - 1) & ~(size_t)(SDS_ARENA_ALIGN - 1);
+}
+
+static SdsArenaChunk* new_chunk(size_t size) {
+    // data가 16바이트 정렬되도록 헤더 크기를 맞춘 뒤 aligned_alloc 사용
+    size_t total = align_up(sizeof(SdsArenaChunk) + size);
+    SdsArenaChunk* chunk = (SdsArenaChunk*)aligned_alloc(SDS_ARENA_ALIGN, total);
+    if (!chunk) {
+        perror("Failed to allocate SdsArenaChunk");
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->size = total - sizeof(SdsArenaChunk);
+    chunk->used = 0;
+    return chunk;
+}
+
+static void free_chunks(SdsArenaChunk* chunk) {
+    while (chunk) {
+        SdsArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+SdsArena* sds_arena_create(size_t chunk_size) {
+    SdsArena* arena = (SdsArena*)calloc(1, sizeof(SdsArena));
+    if (!arena) {
+        perror("Failed to allocate SdsArena");
+        return NULL;
+    }
+    arena->chunk_size = chunk_size ? chunk_size : SDS_ARENA_DEFAULT_CHUNK_SIZE;
+    arena->chunks = new_chunk(arena->chunk_size);
+    if (!arena->chunks) {
+        free(arena);
+        return NULL;
+    }
+    return arena;
+}
+
+void sds_arena_destroy(SdsArena* arena) {
+    if (!arena) return;
+    if (t_active_arena == arena) t_active_arena = NULL;
+    free_chunks(arena->chunks);
+    free(arena);
+}
+
+void* sds_arena_alloc(SdsArena* arena, size_t size) {
+    if (!arena) return NULL;
+    size = align_up(size ? size : 1);
+
+    SdsArenaChunk* chunk = arena->chunks;
+    if (chunk->size - chunk->used < size) {
+        // 현재 청크가 부족하면 새 청크를 앞에 붙인다 (이전 청크의 남은 공간은 reset 때까지 사용하지 않음)
+        SdsArenaChunk* grown = new_chunk(size > arena->chunk_size ? size : arena->chunk_size);
+        if (!grown) return NULL;
+        grown->next = chunk;
+        arena->chunks = grown;
+        chunk = grown;
+    }
+
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    if (arena->used > arena->high_watermark) arena->high_watermark = arena->used;
+    arena->last_alloc = ptr;
+    return ptr;
+}
+
+void* sds_arena_calloc(SdsArena* arena, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void* ptr = sds_arena_alloc(arena, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* sds_arena_realloc(SdsArena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return sds_arena_calloc(arena, 1, new_size);
+    if (new_size <= old_size) return ptr;
+
+    // 마지막 할당이고 청크에 여유가 있으면 제자리에서 확장
+    SdsArenaChunk* chunk = arena->chunks;
+    size_t old_aligned = align_up(old_size ? old_size : 1);
+    size_t new_aligned = align_up(new_size);
+    if (ptr == arena->last_alloc && (char*)ptr + old_aligned == chunk->data + chunk->used &&
+        chunk->size - chunk->used >= new_aligned - old_aligned) {
+        chunk->used += new_aligned - old_aligned;
+        arena->used += new_aligned - old_aligned;
+        if (arena->used > arena->high_watermark) arena->high_watermark = arena->used;
+        memset((char*)ptr + old_size, 0, new_size - old_size);
+        return ptr;
+    }
+
+    void* grown = sds_arena_alloc(arena, new_size);
+    if (!grown) return NULL;
+    memcpy(grown, ptr, old_size);
+    memset((char*)grown + old_size, 0, new_size - old_size);
+    return grown;
+}
+
+void sds_arena_reset(SdsArena* arena) {
+    if (!arena) return;
+    if (arena->chunks->next) {
+        // 여러 청크를 썼다면 다음 프레임은 한 청크에 들어가도록 합친 크기로 다시 만든다
+        size_t total = 0;
+        for (SdsArenaChunk* c = arena->chunks; c; c = c->next) total += c->size;
+        SdsArenaChunk* merged = new_chunk(total);
+        if (merged) {
+            free_chunks(arena->chunks);
+            arena->chunks = merged;
+        } else {
+            free_chunks(arena->chunks->next);
+            arena->chunks->next = NULL;
+        }
+    }
+    arena->chunks->used = 0;
+    arena->used = 0;
+    arena->last_alloc = NULL;
+}
+
+bool sds_arena_owns(const SdsArena* arena, const void* ptr) {
+    if (!arena || !ptr) return false;
+    for (const SdsArenaChunk* c = arena->chunks; c; c = c->next) {
+        if ((const char*)ptr >= c->data && (const char*)ptr < c->data + c->size) return true;
+    }
+    return false;
+}
+
+SdsArenaPool* sds_arena_pool_create(size_t chunk_size) {
+    SdsArenaPool* pool = (SdsArenaPool*)calloc(1, sizeof(SdsArenaPool));
+    if (!pool) {
+        perror("Failed to allocate SdsArenaPool");
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->chunk_size = chunk_size ? chunk_size : SDS_ARENA_DEFAULT_CHUNK_SIZE;
+    return pool;
+}
+
+void sds_arena_pool_destroy(SdsArenaPool* pool) {
+    if (!pool) return;
+    SdsArena* arena = pool->free_list;
+    while (arena) {
+        SdsArena* next = arena->next_free;
+        sds_arena_destroy(arena);
+        arena = next;
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+SdsArena* sds_arena_pool_acquire(SdsArenaPool* pool) {
+    if (!pool) return NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    SdsArena* arena = pool->free_list;
+    if (arena) {
+        pool->free_list = arena->next_free;
+        pool->num_free--;
+    } else {
+        pool->created++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!arena) {
+        arena = sds_arena_create(pool->chunk_size);
+        if (!arena) return NULL;
+        arena->pool = pool;
+    }
+    arena->next_free = NULL;
+    return arena;
+}
+
+void sds_arena_release(SdsArena* arena) {
+    if (!arena) return;
+    SdsArenaPool* pool = arena->pool;
+    sds_arena_reset(arena);
+    if (pool) {
+        pthread_mutex_lock(&pool->lock);
+        if (pool->num_free < SDS_ARENA_POOL_MAX_IDLE) {
+            arena->next_free = pool->free_list;
+            pool->free_list = arena;
+            pool->num_free++;
+            arena = NULL;
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    if (arena) sds_arena_destroy(arena);
+}
+
+void sds_arena_set_active(SdsArena* arena) {
+    t_active_arena = arena;
+}
+
+SdsArena* sds_arena_get_active(void) {
+    return t_active_arena;
+}
+
+void* sds_mem_calloc(size_t count, size_t size) {
+    if (t_active_arena) return sds_arena_calloc(t_active_arena, count, size);
+    return calloc(count, size);
+}
+
+void* sds_mem_realloc(void* ptr, size_t old_size, size_t new_size) {
+    if (t_active_arena) return sds_arena_realloc(t_active_arena, ptr, old_size, new_size);
+    return realloc(ptr, new_size);
+}
+
+void sds_mem_free(void* ptr) {
+    // 아레나 메모리는 reset에서 한꺼번에 해제
+    if (t_active_arena && sds_arena_owns(t_active_arena, ptr)) return;
+    free(ptr);
+}
+
+void* sds_arena_hook_malloc(size_t size) {
+    if (t_active_arena) return sds_arena_alloc(t_active_arena, size);
+    return malloc(size);
+}
+
+void sds_arena_hook_free(void* ptr) {
+    sds_mem_free(ptr);
+}
@@ -0,0 +1,92 @@
+// sds_arena.h
+
+#ifndef SDS_ARENA_H
+#define SDS_ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define SDS_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define SDS_ARENA_POOL_MAX_IDLE 8   // 풀에 보관할 최대 유휴 아레나 수
+
+struct SdsArenaPool;
+
+// 연속 메모리 블록. 아레나가 부족하면 새 청크를 이어 붙인다.
+typedef struct SdsArenaChunk {
+    struct SdsArenaChunk* next;
+    size_t size;
+    size_t used;
+    char data[];
+} SdsArenaChunk;
+
+// 프레임 하나를 파싱하는 동안의 모든 할당을 담는 bump 할당기
+// 해제는 개별 free 없이 sds_arena_reset으로 한 번에 한다.
+typedef struct SdsArena {
+    SdsArenaChunk* chunks;        // 현재 할당 중인 청크 (목록의 첫 번째)
+    size_t chunk_size;            // 새 청크의 최소 크기
+    size_t used;                  // reset 이후 할당한 바이트 (모든 청크 합계)
+    size_t high_watermark;        // 한 번에 가장 많이 사용한 바이트
+    void* last_alloc;             // 마지막 할당 (realloc 시 제자리 확장용)
+    struct SdsArenaPool* pool;    // 반납할 풀 (없으면 NULL)
+    struct SdsArena* next_free;   // 풀의 유휴 목록 연결
+} SdsArena;
+
+// 스레드 간에 아레나를 재사용하기 위한 풀 (파싱 스레드에서 꺼내고, 메시지를 해제하는 스레드에서 반납)
+typedef struct SdsArenaPool {
+    pthread_mutex_t lock;
+    SdsArena* free_list;
+    int num_free;
+    size_t chunk_size;
+    unsigned long created;        // 지금까지 만든 아레나 수
+} SdsArenaPool;
+
+SdsArena* sds_arena_create(size_t chunk_size);
+void sds_arena_destroy(SdsArena* arena);
+
+/**
+ * @brief 16바이트 정렬된 메모리를 할당합니다. (0으로 초기화하지 않음)
+ */
+void* sds_arena_alloc(SdsArena* arena, size_t size);
+void* sds_arena_calloc(SdsArena* arena, size_t count, size_t size);
+
+/**
+ * @brief 마지막 할당이면 제자리에서 늘리고, 아니면 새로 할당해 복사합니다. 늘어난 영역은 0으로 채웁니다.
+ */
+void* sds_arena_realloc(SdsArena* arena, void* ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief 모든 할당을 한 번에 해제합니다. 청크가 여러 개였으면 합친 크기의 청크 하나로 바꿔 다음에는 한 청크에 들어가게 합니다.
+ */
+void sds_arena_reset(SdsArena* arena);
+
+bool sds_arena_owns(const SdsArena* arena, const void* ptr);
+
+SdsArenaPool* sds_arena_pool_create(size_t chunk_size);
+void sds_arena_pool_destroy(SdsArenaPool* pool);
+
+/**
+ * @brief 풀에서 비어 있는 아레나를 꺼냅니다. 없으면 새로 만듭니다.
+ */
+SdsArena* sds_arena_pool_acquire(SdsArenaPool* pool);
+
+/**
+ * @brief 아레나를 비우고 원래 풀에 반납합니다. 풀이 가득 찼거나 풀이 없으면 해제합니다.
+ */
+void sds_arena_release(SdsArena* arena);
+
+// --- 현재 스레드의 활성 아레나 ---
+// 활성 아레나가 있으면 sds_mem_* 와 cJSON 훅이 아레나에서 할당하고, 없으면 일반 힙을 사용한다.
+
+void sds_arena_set_active(SdsArena* arena);
+SdsArena* sds_arena_get_active(void);
+
+void* sds_mem_calloc(size_t count, size_t size);
+void* sds_mem_realloc(void* ptr, size_t old_size, size_t new_size);
+void sds_mem_free(void* ptr);
+
+// cJSON_InitHooks용 할당/해제 함수
+void* sds_arena_hook_malloc(size_t size);
+void sds_arena_hook_free(void* ptr);
+
+#endif // SDS_ARENA_H
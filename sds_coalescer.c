@@ -0,0 +1,75 @@
+// sds_coalescer.c
+
+#include "sds_coalescer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+SdsCoalescer* sds_coalescer_create(size_t max_frame_len) {
+    SdsCoalescer* c = (SdsCoalescer*)calloc(1, sizeof(SdsCoalescer));
+    if (!c) {
+        perror("Failed to allocate SdsCoalescer");
+        return NULL;
+    }
+    c->buffer = (char*)malloc(max_frame_len + 1);
+    if (!c->buffer) {
+        perror("Failed to allocate SdsCoalescer buffer");
+        free(c);
+        return NULL;
+    }
+    c->capacity = max_frame_len;
+    return c;
+}
+
+void sds_coalescer_destroy(SdsCoalescer* c) {
+    if (!c) return;
+    free(c->buffer);
+    free(c);
+}
+
+SdsCoalesceResult sds_coalescer_offer(SdsCoalescer* c, const char* frame, size_t frame_len) {
+    SdsJson_Header_t header;
+    if (frame_len > c->capacity || !sds_json_peek_header(frame, frame_len, &header)) {
+        c->counters.invalid++;
+        return SDS_COALESCE_INVALID;
+    }
+
+    // 보관 중인 후보가 있으면 후보와, 없으면 마지막으로 처리한 프레임과 비교
+    const SdsJson_Header_t* newest = c->has_candidate ? &c->candidate : (c->has_delivered ? &c->delivered : NULL);
+    if (newest) {
+        int cmp = sds_json_header_compare(&header, newest);
+        if (cmp == 0) {
+            c->counters.duplicate++;
+            return SDS_COALESCE_DUPLICATE;
+        }
+        if (cmp < 0 && ++c->consecutive_stale < SDS_COALESCER_RESYNC_STALE) {
+            c->counters.stale++;
+            return SDS_COALESCE_STALE;
+        }
+        if (cmp < 0) {
+            fprintf(stderr, "[Coalesce] %d consecutive stale frames (MsgCount %d, %s). Resynchronizing.\n",
+                    c->consecutive_stale, header.msg_count, header.timestamp);
+            c->counters.resyncs++;
+        }
+    }
+    c->consecutive_stale = 0;
+
+    if (c->has_candidate) c->counters.superseded++;
+    memcpy(c->buffer, frame, frame_len);
+    c->buffer[frame_len] = '\0';
+    c->len = frame_len;
+    c->candidate = header;
+    c->has_candidate = true;
+    c->counters.accepted++;
+    return SDS_COALESCE_ACCEPTED;
+}
+
+bool sds_coalescer_take(SdsCoalescer* c, const char** frame, size_t* frame_len) {
+    if (!c || !c->has_candidate) return false;
+    c->has_candidate = false;
+    c->delivered = c->candidate;
+    c->has_delivered = true;
+    *frame = c->buffer;
+    *frame_len = c->len;
+    return true;
+}
@@ -0,0 +1,62 @@
+// sds_coalescer.h
+
+#ifndef SDS_COALESCER_H
+#define SDS_COALESCER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "sds_json_types.h"
+
+// 한 poll 회차 동안 들어온 프레임 중 가장 새로운 것(MsgCount/Timestamp 기준) 하나만 남긴다.
+// 모든 연결의 프레임이 같은 교차로를 설명하므로 연결 구분 없이 하나의 후보만 유지한다.
+typedef enum {
+    SDS_COALESCE_ACCEPTED = 0,  // 새 후보로 보관 (이전 후보가 있었다면 superseded로 집계)
+    SDS_COALESCE_STALE,         // 이미 처리했거나 보관 중인 메시지보다 오래됨
+    SDS_COALESCE_DUPLICATE,     // 같은 메시지 (다른 송신측의 중복 전송 등)
+    SDS_COALESCE_INVALID        // 헤더를 읽을 수 없거나 버퍼보다 큼
+} SdsCoalesceResult;
+
+// 연속으로 이만큼 오래된 프레임만 들어오면 송신측이 재시작한 것으로 보고 다시 동기화
+#define SDS_COALESCER_RESYNC_STALE (SDS_JSON_MSG_COUNT_MODULUS / 2)
+
+typedef struct {
+    unsigned long accepted;     // 후보로 보관한 프레임 수
+    unsigned long superseded;   // 처리 전에 더 새로운 프레임으로 대체된 프레임 수
+    unsigned long stale;
+    unsigned long duplicate;
+    unsigned long invalid;
+    unsigned long resyncs;      // 송신측 재시작 등으로 순서를 다시 맞춘 횟수
+} SdsCoalescerCounters;
+
+typedef struct {
+    char* buffer;               // 보관 중인 후보 프레임 (널 종료)
+    size_t capacity;
+    size_t len;
+    bool has_candidate;
+    SdsJson_Header_t candidate;
+    bool has_delivered;
+    SdsJson_Header_t delivered; // 마지막으로 처리로 넘긴 프레임의 헤더
+    int consecutive_stale;
+    SdsCoalescerCounters counters;
+} SdsCoalescer;
+
+/**
+ * @brief 코얼레서를 생성합니다.
+ * @param max_frame_len 보관할 수 있는 최대 프레임 길이.
+ */
+SdsCoalescer* sds_coalescer_create(size_t max_frame_len);
+void sds_coalescer_destroy(SdsCoalescer* c);
+
+/**
+ * @brief 프레임 헤더만 읽어 보관 중인 후보 및 마지막 처리 프레임과 비교합니다.
+ * 더 새로우면 복사해 후보로 보관하고, 아니면 버립니다.
+ */
+SdsCoalesceResult sds_coalescer_offer(SdsCoalescer* c, const char* frame, size_t frame_len);
+
+/**
+ * @brief 보관 중인 후보를 꺼냅니다. 반환된 포인터는 다음 offer 전까지 유효합니다.
+ * @return 후보가 있으면 true.
+ */
+bool sds_coalescer_take(SdsCoalescer* c, const char** frame, size_t* frame_len);
+
+#endif // SDS_COALESCER_H
@@ -2,9 +2,11 @@
 
 #include "sds_json_types.h" // 우리가 정의한 구조체 및 함수 프로토타입
 #include "cJSON.h"          // cJSON 라이브러리
+#include "sds_arena.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>    // for strcasecmp
 #include <errno.h>
 
 // --- 정적 헬퍼 함수 프로토타입 선언 ---
@@ -81,7 +83,7 @@ static bool parse_traffic_object(const cJSON* traffic_obj_json, SdsJson_TrafficO
 
     traffic_obj_c->num_way_points = cJSON_GetArraySize(waypoint_list_json);
     if (traffic_obj_c->num_way_points > 0) {
-        traffic_obj_c->way_point_list = (SdsJson_WayPoint_t*)calloc(traffic_obj_c->num_way_points, sizeof(SdsJson_WayPoint_t));
+        traffic_obj_c->way_point_list = (SdsJson_WayPoint_t*)sds_mem_calloc(traffic_obj_c->num_way_points, sizeof(SdsJson_WayPoint_t));
         if (!traffic_obj_c->way_point_list) {
             perror("Failed to allocate memory for WayPointList");
             traffic_obj_c->num_way_points = 0;
@@ -93,7 +95,7 @@ static bool parse_traffic_object(const cJSON* traffic_obj_json, SdsJson_TrafficO
             const cJSON* waypoint_json_value = cJSON_GetObjectItemCaseSensitive(waypoint_item_json_container, "WayPoint");
             if (!parse_waypoint(waypoint_json_value, &traffic_obj_c->way_point_list[idx++])) {
                 // 파싱 실패 시 이미 할당된 way_point_list 해제 필요
-                free(traffic_obj_c->way_point_list);
+                sds_mem_free(traffic_obj_c->way_point_list);
                 traffic_obj_c->way_point_list = NULL;
                 traffic_obj_c->num_way_points = 0;
                 return false;
@@ -152,13 +154,13 @@ static bool parse_approach_traffic_info_data(const cJSON* ati_data_json, SdsJson
 
     // 선택적 ConflictPos 파싱
     if (cJSON_IsObject(conflict_pos_json)) {
-        ati_data_c->conflict_pos = (SdsJson_ConflictPosition_t*)calloc(1, sizeof(SdsJson_ConflictPosition_t));
+        ati_data_c->conflict_pos = (SdsJson_ConflictPosition_t*)sds_mem_calloc(1, sizeof(SdsJson_ConflictPosition_t));
         if (!ati_data_c->conflict_pos) {
             perror("Failed to allocate memory for ConflictPosition");
             return false;
         }
         if (!parse_conflict_position(conflict_pos_json, ati_data_c->conflict_pos)) {
-            free(ati_data_c->conflict_pos);
+            sds_mem_free(ati_data_c->conflict_pos);
             ati_data_c->conflict_pos = NULL;
             return false; // ConflictPos 파싱 실패
         }
@@ -178,27 +180,33 @@ static bool parse_approach_traffic_info_data(const cJSON* ati_data_json, SdsJson
     // HostObject 파싱 (필수)
     if (!parse_traffic_object(host_obj_json, &ati_data_c->host_object)) {
         // HostObject 파싱 실패 시, 할당된 conflict_pos 해제 필요
-        if(ati_data_c->conflict_pos) free(ati_data_c->conflict_pos);
+        if(ati_data_c->conflict_pos) sds_mem_free(ati_data_c->conflict_pos);
         ati_data_c->conflict_pos = NULL;
         return false;
     }
 
     // 선택적 RemoteObject 파싱
     if (cJSON_IsObject(remote_obj_json)) {
-        ati_data_c->remote_object = (SdsJson_TrafficObject_t*)calloc(1, sizeof(SdsJson_TrafficObject_t));
+        ati_data_c->remote_object = (SdsJson_TrafficObject_t*)sds_mem_calloc(1, sizeof(SdsJson_TrafficObject_t));
         if (!ati_data_c->remote_object) {
             perror("Failed to allocate memory for RemoteObject");
-            // 이전에 할당된 자원들 해제 필요
-            if(ati_data_c->conflict_pos) free(ati_data_c->conflict_pos);
-            if(ati_data_c->host_object.way_point_list) free(ati_data_c->host_object.way_point_list);
+            // 이전에 할당된 자원들 해제 필요 (free_sds_json_main_message에서 다시 해제하지 않도록 NULL로)
+            sds_mem_free(ati_data_c->conflict_pos);
+            ati_data_c->conflict_pos = NULL;
+            sds_mem_free(ati_data_c->host_object.way_point_list);
+            ati_data_c->host_object.way_point_list = NULL;
+            ati_data_c->host_object.num_way_points = 0;
             return false;
         }
         if (!parse_traffic_object(remote_obj_json, ati_data_c->remote_object)) {
             // RemoteObject 파싱 실패 시, 할당된 자원들 해제 필요
-            free(ati_data_c->remote_object); // 방금 할당한 remote_object
+            sds_mem_free(ati_data_c->remote_object); // 방금 할당한 remote_object
             ati_data_c->remote_object = NULL;
-            if(ati_data_c->conflict_pos) free(ati_data_c->conflict_pos);
-            if(ati_data_c->host_object.way_point_list) free(ati_data_c->host_object.way_point_list);
+            sds_mem_free(ati_data_c->conflict_pos);
+            ati_data_c->conflict_pos = NULL;
+            sds_mem_free(ati_data_c->host_object.way_point_list);
+            ati_data_c->host_object.way_point_list = NULL;
+            ati_data_c->host_object.num_way_points = 0;
             return false;
         }
     } else {
@@ -208,13 +216,201 @@ static bool parse_approach_traffic_info_data(const cJSON* ati_data_json, SdsJson
     return true;
 }
 
+// 문자열 시작(") 다음 위치부터 닫는 따옴표를 찾는다. 없으면 NULL
+static const char* skip_json_string(const char* p, const char* end) {
+    while (p < end) {
+        if (*p == '\\') {
+            p += 2;
+            continue;
+        }
+        if (*p == '"') return p;
+        p++;
+    }
+    return NULL;
+}
+
+static const char* skip_json_whitespace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+
+static SdsJson_ParserKind g_parser_kind = SDS_JSON_PARSER_CJSON;
+static SdsArenaPool* g_arena_pool = NULL; // NULL이면 아레나를 사용하지 않음
+static bool g_lazy_waypoints = false;
+static unsigned long g_verify_count = 0;
+static unsigned long g_verify_mismatches = 0;
+
+static bool waypoints_equal(const SdsJson_WayPoint_t* a, const SdsJson_WayPoint_t* b) {
+    return a->lat == b->lat && a->lon == b->lon &&
+           a->has_elevation == b->has_elevation && a->elevation == b->elevation &&
+           a->time_offset == b->time_offset && a->speed == b->speed &&
+           a->has_heading == b->has_heading && a->heading == b->heading;
+}
+
+static bool traffic_objects_equal(const SdsJson_TrafficObject_t* a, const SdsJson_TrafficObject_t* b, const char* what, char* diff, size_t diff_size) {
+    if (strcmp(a->object_type, b->object_type) != 0 || strcmp(a->object_id, b->object_id) != 0 ||
+        a->is_driving_intent_shared != b->is_driving_intent_shared || a->ig_intersection_intent != b->ig_intersection_intent) {
+        snprintf(diff, diff_size, "%s fields", what);
+        return false;
+    }
+    if (a->num_way_points != b->num_way_points) {
+        snprintf(diff, diff_size, "%s WayPointList size %d != %d", what, a->num_way_points, b->num_way_points);
+        return false;
+    }
+    for (int i = 0; i < a->num_way_points; ++i) {
+        const SdsJson_WayPoint_t* wa = sds_json_get_waypoint(a, i);
+        const SdsJson_WayPoint_t* wb = sds_json_get_waypoint(b, i);
+        if (!wa || !wb || !waypoints_equal(wa, wb)) {
+            snprintf(diff, diff_size, "%s WayPoint[%d]", what, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 파서 출력 비교 결과 하나를 기록 (verify 모드)
+static void record_verify_result(const SdsJson_MainMessage_t* reference, const SdsJson_MainMessage_t* candidate) {
+    char diff[128];
+    g_verify_count++;
+    if (sds_json_messages_equal(reference, candidate, diff, sizeof(diff))) return;
+    g_verify_mismatches++;
+    fprintf(stderr, "[JSON verify] stream parser mismatch (MsgCount %d): %s (%lu/%lu frames)\n",
+            reference ? reference->msg_count : (candidate ? candidate->msg_count : -1), diff,
+            g_verify_mismatches, g_verify_count);
+}
+
+static SdsJson_MainMessage_t* cjson_parse_message(const char* json_string, size_t json_len);
 
 // --- 공개 함수 구현 ---
 
 SdsJson_MainMessage_t* sds_json_parse_message(const char* json_string) {
     if (!json_string) return NULL;
+    return sds_json_parse_message_len(json_string, strlen(json_string));
+}
+
+static SdsJson_MainMessage_t* parse_with_selected_parser(const char* json_string, size_t json_len) {
+    switch (g_parser_kind) {
+        case SDS_JSON_PARSER_STREAM:
+            return sds_json_stream_parse_message(json_string, json_len, g_lazy_waypoints);
+        case SDS_JSON_PARSER_VERIFY: {
+            SdsJson_MainMessage_t* reference = cjson_parse_message(json_string, json_len);
+            // 비교용 결과는 바로 해제하므로 아레나 밖(힙)에 만든다
+            SdsArena* arena = sds_arena_get_active();
+            sds_arena_set_active(NULL);
+            SdsJson_MainMessage_t* candidate = sds_json_stream_parse_message(json_string, json_len, g_lazy_waypoints);
+            record_verify_result(reference, candidate);
+            free_sds_json_main_message(candidate);
+            sds_arena_set_active(arena);
+            return reference;
+        }
+        default:
+            return cjson_parse_message(json_string, json_len);
+    }
+}
+
+SdsJson_MainMessage_t* sds_json_parse_message_len(const char* json_string, size_t json_len) {
+    if (!json_string) return NULL;
 
-    cJSON *root_json = cJSON_Parse(json_string);
+    // 아레나 모드에서는 파싱 중의 모든 할당(cJSON 노드 포함)이 이 아레나로 간다
+    SdsArena* arena = sds_arena_pool_acquire(g_arena_pool);
+    sds_arena_set_active(arena);
+    SdsJson_MainMessage_t* msg_data = parse_with_selected_parser(json_string, json_len);
+    sds_arena_set_active(NULL);
+
+    if (msg_data) {
+        msg_data->arena = arena;
+    } else {
+        sds_arena_release(arena);
+    }
+    return msg_data;
+}
+
+void sds_json_set_lazy_waypoints(bool enable) {
+    g_lazy_waypoints = enable;
+}
+
+const SdsJson_WayPoint_t* sds_json_get_waypoint(const SdsJson_TrafficObject_t* traffic_obj, int index) {
+    if (!traffic_obj || index < 0 || index >= traffic_obj->num_way_points) return NULL;
+    if (!traffic_obj->way_point_decoded || traffic_obj->way_point_decoded[index]) {
+        return &traffic_obj->way_point_list[index];
+    }
+    // 디코딩 결과는 메시지 안의 캐시(way_point_list)에 채우므로 const를 벗겨 기록
+    if (!sds_json_stream_decode_waypoint((SdsJson_TrafficObject_t*)traffic_obj, index)) return NULL;
+    return &traffic_obj->way_point_list[index];
+}
+
+void sds_json_use_arena(bool enable) {
+    if (enable && !g_arena_pool) {
+        g_arena_pool = sds_arena_pool_create(SDS_ARENA_DEFAULT_CHUNK_SIZE);
+        if (!g_arena_pool) return;
+        cJSON_Hooks hooks = { sds_arena_hook_malloc, sds_arena_hook_free };
+        cJSON_InitHooks(&hooks);
+    } else if (!enable && g_arena_pool) {
+        cJSON_InitHooks(NULL);
+        sds_arena_pool_destroy(g_arena_pool);
+        g_arena_pool = NULL;
+    }
+}
+
+void sds_json_set_parser(SdsJson_ParserKind kind) {
+    g_parser_kind = kind;
+}
+
+SdsJson_ParserKind sds_json_parser_from_string(const char* str) {
+    if (str) {
+        if (strcasecmp(str, "stream") == 0) return SDS_JSON_PARSER_STREAM;
+        if (strcasecmp(str, "verify") == 0) return SDS_JSON_PARSER_VERIFY;
+    }
+    return SDS_JSON_PARSER_CJSON;
+}
+
+bool sds_json_messages_equal(const SdsJson_MainMessage_t* a, const SdsJson_MainMessage_t* b, char* diff, size_t diff_size) {
+    if (!a || !b) {
+        if (a == b) return true;
+        snprintf(diff, diff_size, "%s parser rejected the frame", a ? "stream" : "cJSON");
+        return false;
+    }
+    if (a->msg_count != b->msg_count || strcmp(a->timestamp, b->timestamp) != 0) {
+        snprintf(diff, diff_size, "MsgCount/Timestamp");
+        return false;
+    }
+    if (a->num_approach_traffic_info != b->num_approach_traffic_info) {
+        snprintf(diff, diff_size, "ApproachTrafficInfoList size %d != %d", a->num_approach_traffic_info, b->num_approach_traffic_info);
+        return false;
+    }
+    for (int i = 0; i < a->num_approach_traffic_info; ++i) {
+        const SdsJson_ApproachTrafficInfoData_t* x = &a->approach_traffic_info_list[i];
+        const SdsJson_ApproachTrafficInfoData_t* y = &b->approach_traffic_info_list[i];
+        char what[48];
+
+        if (x->cvib_dir_code != y->cvib_dir_code || x->has_pet != y->has_pet || x->pet != y->pet ||
+            x->pet_threshold != y->pet_threshold) {
+            snprintf(diff, diff_size, "ApproachTrafficInfo[%d] fields", i);
+            return false;
+        }
+        if ((x->conflict_pos == NULL) != (y->conflict_pos == NULL) ||
+            (x->conflict_pos && (x->conflict_pos->lat != y->conflict_pos->lat || x->conflict_pos->lon != y->conflict_pos->lon ||
+                                 x->conflict_pos->has_elevation != y->conflict_pos->has_elevation ||
+                                 x->conflict_pos->elevation != y->conflict_pos->elevation))) {
+            snprintf(diff, diff_size, "ApproachTrafficInfo[%d] ConflictPos", i);
+            return false;
+        }
+        snprintf(what, sizeof(what), "ApproachTrafficInfo[%d] HostObject", i);
+        if (!traffic_objects_equal(&x->host_object, &y->host_object, what, diff, diff_size)) return false;
+        if ((x->remote_object == NULL) != (y->remote_object == NULL)) {
+            snprintf(diff, diff_size, "ApproachTrafficInfo[%d] RemoteObject presence", i);
+            return false;
+        }
+        snprintf(what, sizeof(what), "ApproachTrafficInfo[%d] RemoteObject", i);
+        if (x->remote_object && !traffic_objects_equal(x->remote_object, y->remote_object, what, diff, diff_size)) return false;
+    }
+    return true;
+}
+
+// cJSON 트리를 만든 뒤 구조체로 복사하는 기존 파서
+static SdsJson_MainMessage_t* cjson_parse_message(const char* json_string, size_t json_len) {
+    cJSON *root_json = cJSON_ParseWithLength(json_string, json_len);
     if (root_json == NULL) {
         const char *error_ptr = cJSON_GetErrorPtr();
         if (error_ptr != NULL) {
@@ -225,7 +421,7 @@ SdsJson_MainMessage_t* sds_json_parse_message(const char* json_string) {
         return NULL;
     }
 
-    SdsJson_MainMessage_t* msg_data = (SdsJson_MainMessage_t*)calloc(1, sizeof(SdsJson_MainMessage_t));
+    SdsJson_MainMessage_t* msg_data = (SdsJson_MainMessage_t*)sds_mem_calloc(1, sizeof(SdsJson_MainMessage_t));
     if (!msg_data) {
         perror("Failed to allocate memory for SdsJson_MainMessage_t");
         cJSON_Delete(root_json);
@@ -256,7 +452,7 @@ SdsJson_MainMessage_t* sds_json_parse_message(const char* json_string) {
     if (parse_ok && cJSON_IsArray(ati_list_json)) {
         msg_data->num_approach_traffic_info = cJSON_GetArraySize(ati_list_json);
         if (msg_data->num_approach_traffic_info > 0) {
-            msg_data->approach_traffic_info_list = (SdsJson_ApproachTrafficInfoData_t*)calloc(msg_data->num_approach_traffic_info, sizeof(SdsJson_ApproachTrafficInfoData_t));
+            msg_data->approach_traffic_info_list = (SdsJson_ApproachTrafficInfoData_t*)sds_mem_calloc(msg_data->num_approach_traffic_info, sizeof(SdsJson_ApproachTrafficInfoData_t));
             if (!msg_data->approach_traffic_info_list) {
                 perror("Failed to allocate memory for ApproachTrafficInfoList");
                 msg_data->num_approach_traffic_info = 0;
@@ -292,30 +488,107 @@ SdsJson_MainMessage_t* sds_json_parse_message(const char* json_string) {
     return msg_data;
 }
 
+bool sds_json_peek_header(const char* json_string, size_t json_len, SdsJson_Header_t* out_header) {
+    if (!json_string || !out_header) return false;
+
+    const char* p = json_string;
+    const char* end = json_string + json_len;
+    int depth = 0;
+    bool has_msg_count = false;
+    bool has_timestamp = false;
+    out_header->msg_count = 0;
+    out_header->timestamp[0] = '\0';
+
+    while (p < end && !(has_msg_count && has_timestamp)) {
+        char c = *p;
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth <= 0) break; // 최상위 객체 끝
+        } else if (c == '"') {
+            const char* key = p + 1;
+            const char* key_end = skip_json_string(key, end);
+            if (!key_end) break;
+            p = key_end + 1;
+            if (depth != 1) continue;
+
+            const char* value = skip_json_whitespace(p, end);
+            if (value >= end || *value != ':') continue; // 키가 아닌 문자열 값
+            value = skip_json_whitespace(value + 1, end);
+            size_t key_len = (size_t)(key_end - key);
+
+            if (key_len == 8 && memcmp(key, "MsgCount", 8) == 0) {
+                char* num_end = NULL;
+                long v = strtol(value, &num_end, 10);
+                if (num_end == value) return false;
+                out_header->msg_count = (int)v;
+                has_msg_count = true;
+                p = num_end;
+            } else if (key_len == 9 && memcmp(key, "Timestamp", 9) == 0 && value < end && *value == '"') {
+                const char* ts_end = skip_json_string(value + 1, end);
+                if (!ts_end) break;
+                size_t ts_len = (size_t)(ts_end - value - 1);
+                if (ts_len >= sizeof(out_header->timestamp)) ts_len = sizeof(out_header->timestamp) - 1;
+                memcpy(out_header->timestamp, value + 1, ts_len);
+                out_header->timestamp[ts_len] = '\0';
+                has_timestamp = true;
+                p = ts_end + 1;
+            }
+            continue;
+        }
+        p++;
+    }
+    return has_msg_count;
+}
+
+int sds_json_header_compare(const SdsJson_Header_t* a, const SdsJson_Header_t* b) {
+    // "YYYY-MM-DD HH:MM:SS" 까지는 문자열 순서가 시간 순서와 같다
+    if (a->timestamp[0] != '\0' && b->timestamp[0] != '\0') {
+        int ts_cmp = strncmp(a->timestamp, b->timestamp, 19);
+        if (ts_cmp != 0) return ts_cmp > 0 ? 1 : -1;
+    }
+    // 같은 초 안에서는 MsgCount 순환 거리로 판단 (절반 이내 앞서 있으면 더 새로운 메시지)
+    int diff = ((a->msg_count - b->msg_count) % SDS_JSON_MSG_COUNT_MODULUS + SDS_JSON_MSG_COUNT_MODULUS) % SDS_JSON_MSG_COUNT_MODULUS;
+    if (diff == 0) return 0;
+    return diff < SDS_JSON_MSG_COUNT_MODULUS / 2 ? 1 : -1;
+}
+
+// TrafficObject가 가진 WayPoint 관련 배열 해제
+static void free_traffic_object_waypoints(SdsJson_TrafficObject_t* traffic_obj) {
+    if (traffic_obj->way_point_list) {
+        sds_mem_free(traffic_obj->way_point_list);
+    }
+    sds_mem_free(traffic_obj->way_point_offsets);
+    sds_mem_free(traffic_obj->way_point_decoded);
+}
+
 void free_sds_json_main_message(SdsJson_MainMessage_t* msg_data) {
     if (!msg_data) return;
 
+    // 아레나에 할당된 메시지는 아레나를 비워 반납하는 것으로 끝 (msg_data 자신도 아레나 안에 있음)
+    if (msg_data->arena) {
+        sds_arena_release(msg_data->arena);
+        return;
+    }
+
     if (msg_data->approach_traffic_info_list) {
         for (int i = 0; i < msg_data->num_approach_traffic_info; ++i) {
             SdsJson_ApproachTrafficInfoData_t* ati_data = &msg_data->approach_traffic_info_list[i];
             
             // host_object의 waypoint_list 해제
-            if (ati_data->host_object.way_point_list) {
-                free(ati_data->host_object.way_point_list);
-            }
+            free_traffic_object_waypoints(&ati_data->host_object);
             // remote_object 해제 (존재한다면)
             if (ati_data->remote_object) {
-                if (ati_data->remote_object->way_point_list) {
-                    free(ati_data->remote_object->way_point_list);
-                }
-                free(ati_data->remote_object);
+                free_traffic_object_waypoints(ati_data->remote_object);
+                sds_mem_free(ati_data->remote_object);
             }
             // conflict_pos 해제 (존재한다면)
             if (ati_data->conflict_pos) {
-                free(ati_data->conflict_pos);
+                sds_mem_free(ati_data->conflict_pos);
             }
         }
-        free(msg_data->approach_traffic_info_list);
+        sds_mem_free(msg_data->approach_traffic_info_list);
     }
-    free(msg_data);
+    sds_mem_free(msg_data->source);
+    sds_mem_free(msg_data);
 }
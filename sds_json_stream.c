@@ -0,0 +1,755 @@
+// sds_json_stream.c
+// cJSON 트리를 만들지 않고 SDSM 프레임을 한 번 훑으면서 SdsJson 구조체를 바로 채우는 파서
+//
+// 검증 규칙은 sds_json_parser.c의 cJSON 경로와 같게 맞춘다.
+//  - 같은 키가 여러 번 나오면 첫 번째 값만 사용 (cJSON_GetObjectItemCaseSensitive와 동일)
+//  - 알 수 없는 키의 값은 문법만 검사하고 버림
+//  - 숫자는 cJSON과 같이 숫자 문자 구간을 strtod로 변환, 정수 필드는 cJSON의 valueint와 같은 방식으로 변환
+//  - 최상위 객체 뒤에 오는 내용은 검사하지 않음 (cJSON_Parse와 동일)
+//
+// 지연 디코딩 모드에서는 WayPointList의 각 원소 위치만 기록하고 첫/마지막 원소만 바로 디코딩한다.
+// 나머지 원소는 구조(괄호, 문자열)만 검사하고 숫자 변환과 필수 필드 검사는 sds_json_get_waypoint에서 읽을 때 한다.
+
+#include "sds_json_types.h"
+#include "sds_arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define STREAM_NESTING_LIMIT 1000       // cJSON의 CJSON_NESTING_LIMIT과 동일
+#define STREAM_INITIAL_ARRAY_CAPACITY 16
+#define STREAM_KEY_MAX 32               // 스키마의 키는 모두 이보다 짧다
+
+typedef struct {
+    const char* p;
+    const char* end;
+    int depth;
+    const char* base;           // 원문 시작 (WayPoint 오프셋 기준)
+    bool lazy_waypoints;        // WayPointList를 오프셋으로만 기록
+    bool fast_numbers;          // 숫자를 strtod 없이 건너뜀 (지연 디코딩할 WayPoint 내부)
+} StreamCursor;
+
+// --- 정적 헬퍼 함수 프로토타입 선언 ---
+static bool skip_value(StreamCursor* c);
+static bool parse_traffic_object(StreamCursor* c, SdsJson_TrafficObject_t* traffic_obj_c);
+
+// --- 토큰 단위 헬퍼 ---
+
+static void skip_whitespace(StreamCursor* c) {
+    while (c->p < c->end && (unsigned char)*c->p <= 32) c->p++;
+}
+
+static bool peek_char(StreamCursor* c, char ch) {
+    skip_whitespace(c);
+    return c->p < c->end && *c->p == ch;
+}
+
+static bool is_number_start(StreamCursor* c) {
+    skip_whitespace(c);
+    return c->p < c->end && (*c->p == '-' || (*c->p >= '0' && *c->p <= '9'));
+}
+
+static bool parse_hex4(const char* p, unsigned int* out) {
+    unsigned int v = 0;
+    for (int i = 0; i < 4; ++i) {
+        char ch = p[i];
+        v <<= 4;
+        if (ch >= '0' && ch <= '9') v |= (unsigned int)(ch - '0');
+        else if (ch >= 'a' && ch <= 'f') v |= (unsigned int)(ch - 'a' + 10);
+        else if (ch >= 'A' && ch <= 'F') v |= (unsigned int)(ch - 'A' + 10);
+        else return false;
+    }
+    *out = v;
+    return true;
+}
+
+// out에 여유가 있는 만큼만 쓰고, 넘치는 부분은 버린다 (문자열은 항상 끝까지 검사)
+static void put_byte(char* out, size_t out_size, size_t* pos, unsigned char byte) {
+    if (out && *pos + 1 < out_size) out[*pos] = (char)byte;
+    (*pos)++;
+}
+
+// \uXXXX (서로게이트 쌍 포함)을 UTF-8로 변환. 소비한 입력 길이를 반환, 실패 시 0
+static int decode_utf16_escape(const char* p, const char* end, char* out, size_t out_size, size_t* pos) {
+    unsigned int first_code = 0;
+    unsigned long codepoint;
+    int sequence_length = 6;
+
+    if (end - p < 6 || !parse_hex4(p + 2, &first_code)) return 0;
+    if (first_code >= 0xDC00 && first_code <= 0xDFFF) return 0; // 짝이 없는 하위 서로게이트
+
+    if (first_code >= 0xD800 && first_code <= 0xDBFF) {
+        unsigned int second_code = 0;
+        if (end - p < 12 || p[6] != '\\' || p[7] != 'u' || !parse_hex4(p + 8, &second_code)) return 0;
+        if (second_code < 0xDC00 || second_code > 0xDFFF) return 0;
+        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
+        sequence_length = 12;
+    } else {
+        codepoint = first_code;
+    }
+
+    if (codepoint < 0x80) {
+        put_byte(out, out_size, pos, (unsigned char)codepoint);
+    } else if (codepoint < 0x800) {
+        put_byte(out, out_size, pos, (unsigned char)(0xC0 | (codepoint >> 6)));
+        put_byte(out, out_size, pos, (unsigned char)(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint < 0x10000) {
+        put_byte(out, out_size, pos, (unsigned char)(0xE0 | (codepoint >> 12)));
+        put_byte(out, out_size, pos, (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F)));
+        put_byte(out, out_size, pos, (unsigned char)(0x80 | (codepoint & 0x3F)));
+    } else {
+        put_byte(out, out_size, pos, (unsigned char)(0xF0 | (codepoint >> 18)));
+        put_byte(out, out_size, pos, (unsigned char)(0x80 | ((codepoint >> 12) & 0x3F)));
+        put_byte(out, out_size, pos, (unsigned char)(0x80 | ((codepoint >> 6) & 0x3F)));
+        put_byte(out, out_size, pos, (unsigned char)(0x80 | (codepoint & 0x3F)));
+    }
+    return sequence_length;
+}
+
+// 문자열 하나를 읽어 out에 널 종료로 복사 (out이 NULL이면 검사만)
+static bool parse_string(StreamCursor* c, char* out, size_t out_size) {
+    skip_whitespace(c);
+    if (c->p >= c->end || *c->p != '"') return false;
+
+    // 닫는 따옴표 위치를 먼저 찾는다
+    const char* start = c->p + 1;
+    const char* close = start;
+    while (close < c->end && *close != '"') {
+        if (*close == '\\') {
+            if (close + 1 >= c->end) return false;
+            close++;
+        }
+        close++;
+    }
+    if (close >= c->end) return false;
+
+    size_t pos = 0;
+    const char* p = start;
+    while (p < close) {
+        if (*p != '\\') {
+            put_byte(out, out_size, &pos, (unsigned char)*p++);
+            continue;
+        }
+        int sequence_length = 2;
+        switch (p[1]) {
+            case 'b': put_byte(out, out_size, &pos, '\b'); break;
+            case 'f': put_byte(out, out_size, &pos, '\f'); break;
+            case 'n': put_byte(out, out_size, &pos, '\n'); break;
+            case 'r': put_byte(out, out_size, &pos, '\r'); break;
+            case 't': put_byte(out, out_size, &pos, '\t'); break;
+            case '"':
+            case '\\':
+            case '/':
+                put_byte(out, out_size, &pos, (unsigned char)p[1]);
+                break;
+            case 'u':
+                sequence_length = decode_utf16_escape(p, close, out, out_size, &pos);
+                if (sequence_length == 0) return false;
+                break;
+            default:
+                return false;
+        }
+        p += sequence_length;
+    }
+    if (out && out_size > 0) out[pos < out_size ? pos : out_size - 1] = '\0';
+
+    c->p = close + 1;
+    return true;
+}
+
+static bool parse_number(StreamCursor* c, double* out) {
+    skip_whitespace(c);
+    const char* run_end = c->p;
+    while (run_end < c->end && ((*run_end >= '0' && *run_end <= '9') || *run_end == '+' || *run_end == '-' ||
+                                *run_end == 'e' || *run_end == 'E' || *run_end == '.')) {
+        run_end++;
+    }
+
+    // strtod가 숫자 구간 밖(16진수, inf 등)을 읽지 않도록 복사해서 변환
+    char local_buf[64];
+    size_t run_len = (size_t)(run_end - c->p);
+    char* buf = (run_len < sizeof(local_buf)) ? local_buf : (char*)malloc(run_len + 1);
+    if (!buf) return false;
+    memcpy(buf, c->p, run_len);
+    buf[run_len] = '\0';
+
+    char* num_end = NULL;
+    *out = strtod(buf, &num_end);
+    size_t consumed = (size_t)(num_end - buf);
+    if (buf != local_buf) free(buf);
+    if (consumed == 0) return false;
+
+    c->p += consumed;
+    return true;
+}
+
+// 값을 쓰지 않는 숫자는 변환 없이 숫자 문자 구간만 건너뜀
+static bool skip_number_run(StreamCursor* c) {
+    const char* start = c->p;
+    while (c->p < c->end && ((*c->p >= '0' && *c->p <= '9') || *c->p == '+' || *c->p == '-' ||
+                             *c->p == 'e' || *c->p == 'E' || *c->p == '.')) {
+        c->p++;
+    }
+    return c->p > start;
+}
+
+// cJSON의 valueint와 같은 변환 (범위를 넘으면 INT_MAX/INT_MIN)
+static int number_to_int(double number) {
+    if (number >= INT_MAX) return INT_MAX;
+    if (number <= (double)INT_MIN) return INT_MIN;
+    return (int)number;
+}
+
+static bool parse_literal(StreamCursor* c, const char* literal, size_t len) {
+    if ((size_t)(c->end - c->p) < len || strncmp(c->p, literal, len) != 0) return false;
+    c->p += len;
+    return true;
+}
+
+// true/false 값. 다른 타입이면 false 반환하고 위치는 그대로
+static bool parse_bool(StreamCursor* c, bool* out) {
+    skip_whitespace(c);
+    if (parse_literal(c, "true", 4)) { *out = true; return true; }
+    if (parse_literal(c, "false", 5)) { *out = false; return true; }
+    return false;
+}
+
+// 객체를 열고('{') 중첩 깊이를 올린다
+static bool enter_container(StreamCursor* c, char open) {
+    skip_whitespace(c);
+    if (c->p >= c->end || *c->p != open) return false;
+    if (++c->depth > STREAM_NESTING_LIMIT) return false;
+    c->p++;
+    return true;
+}
+
+// 객체의 다음 멤버 키를 읽고 값 위치로 이동
+// 키를 읽었으면 1, 객체가 끝났으면 0 ('}' 소비), 문법 오류면 -1
+static int next_member(StreamCursor* c, bool* first, char* key, size_t key_size) {
+    skip_whitespace(c);
+    if (c->p >= c->end) return -1;
+    if (*c->p == '}') {
+        c->p++;
+        c->depth--;
+        return 0;
+    }
+    if (!*first) {
+        if (*c->p != ',') return -1;
+        c->p++;
+    }
+    *first = false;
+    if (!parse_string(c, key, key_size)) return -1;
+    skip_whitespace(c);
+    if (c->p >= c->end || *c->p != ':') return -1;
+    c->p++;
+    return 1;
+}
+
+// 배열의 다음 원소 위치로 이동
+// 원소가 있으면 1, 배열이 끝났으면 0 (']' 소비), 문법 오류면 -1
+static int next_element(StreamCursor* c, bool* first) {
+    skip_whitespace(c);
+    if (c->p >= c->end) return -1;
+    if (*c->p == ']') {
+        c->p++;
+        c->depth--;
+        return 0;
+    }
+    if (!*first) {
+        if (*c->p != ',') return -1;
+        c->p++;
+    }
+    *first = false;
+    return 1;
+}
+
+static bool skip_value(StreamCursor* c) {
+    skip_whitespace(c);
+    if (c->p >= c->end) return false;
+
+    switch (*c->p) {
+        case '"':
+            return parse_string(c, NULL, 0);
+        case '{': {
+            char key[STREAM_KEY_MAX];
+            bool first = true;
+            int r;
+            if (!enter_container(c, '{')) return false;
+            while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+                if (!skip_value(c)) return false;
+            }
+            return r == 0;
+        }
+        case '[': {
+            bool first = true;
+            int r;
+            if (!enter_container(c, '[')) return false;
+            while ((r = next_element(c, &first)) == 1) {
+                if (!skip_value(c)) return false;
+            }
+            return r == 0;
+        }
+        case 't': return parse_literal(c, "true", 4);
+        case 'f': return parse_literal(c, "false", 5);
+        case 'n': return parse_literal(c, "null", 4);
+        default: {
+            double ignored;
+            if (!is_number_start(c)) return false;
+            return c->fast_numbers ? skip_number_run(c) : parse_number(c, &ignored);
+        }
+    }
+}
+
+// --- 필드 단위 헬퍼 (첫 번째로 나온 키만 사용) ---
+
+// 숫자 필드. 첫 번째 값이 숫자가 아니면 건너뛰고 valid 비트를 세우지 않는다.
+static bool read_number_member(StreamCursor* c, unsigned* seen, unsigned* valid, unsigned bit, double* out) {
+    if ((*seen & bit) || !is_number_start(c)) {
+        *seen |= bit;
+        return skip_value(c);
+    }
+    *seen |= bit;
+    if (!parse_number(c, out)) return false;
+    *valid |= bit;
+    return true;
+}
+
+static bool read_string_member(StreamCursor* c, unsigned* seen, unsigned* valid, unsigned bit, char* out, size_t out_size) {
+    if ((*seen & bit) || !peek_char(c, '"')) {
+        *seen |= bit;
+        return skip_value(c);
+    }
+    *seen |= bit;
+    if (!parse_string(c, out, out_size)) return false;
+    *valid |= bit;
+    return true;
+}
+
+static bool read_bool_member(StreamCursor* c, unsigned* seen, unsigned* valid, unsigned bit, bool* out) {
+    if (*seen & bit) return skip_value(c);
+    *seen |= bit;
+    if (parse_bool(c, out)) {
+        *valid |= bit;
+        return true;
+    }
+    return skip_value(c);
+}
+
+// 배열 용량을 두 배로 늘리고 새 영역을 0으로 채움
+static void* grow_array(void* array, int* capacity, size_t element_size) {
+    int new_capacity = (*capacity > 0) ? *capacity * 2 : STREAM_INITIAL_ARRAY_CAPACITY;
+    void* grown = sds_mem_realloc(array, (size_t)*capacity * element_size, (size_t)new_capacity * element_size);
+    if (!grown) return NULL;
+    memset((char*)grown + (size_t)*capacity * element_size, 0, (size_t)(new_capacity - *capacity) * element_size);
+    *capacity = new_capacity;
+    return grown;
+}
+
+// --- 스키마 단위 파서 ---
+
+enum {
+    WP_LAT = 1u << 0, WP_LON = 1u << 1, WP_ELEVATION = 1u << 2,
+    WP_TIME_OFFSET = 1u << 3, WP_SPEED = 1u << 4, WP_HEADING = 1u << 5
+};
+
+static bool parse_waypoint(StreamCursor* c, SdsJson_WayPoint_t* waypoint_c) {
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    unsigned seen = 0, valid = 0;
+    int r;
+
+    if (!enter_container(c, '{')) return false;
+    while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+        bool ok;
+        if (strcmp(key, "lat") == 0)             ok = read_number_member(c, &seen, &valid, WP_LAT, &waypoint_c->lat);
+        else if (strcmp(key, "lon") == 0)        ok = read_number_member(c, &seen, &valid, WP_LON, &waypoint_c->lon);
+        else if (strcmp(key, "elevation") == 0)  ok = read_number_member(c, &seen, &valid, WP_ELEVATION, &waypoint_c->elevation);
+        else if (strcmp(key, "timeOffset") == 0) ok = read_number_member(c, &seen, &valid, WP_TIME_OFFSET, &waypoint_c->time_offset);
+        else if (strcmp(key, "speed") == 0)      ok = read_number_member(c, &seen, &valid, WP_SPEED, &waypoint_c->speed);
+        else if (strcmp(key, "heading") == 0)    ok = read_number_member(c, &seen, &valid, WP_HEADING, &waypoint_c->heading);
+        else                                     ok = skip_value(c);
+        if (!ok) return false;
+    }
+    if (r < 0) return false;
+
+    unsigned mandatory = WP_LAT | WP_LON | WP_TIME_OFFSET | WP_SPEED;
+    if ((valid & mandatory) != mandatory) {
+        fprintf(stderr, "Error: WayPoint mandatory fields missing or wrong type.\n");
+        return false;
+    }
+    waypoint_c->has_elevation = (valid & WP_ELEVATION) != 0;
+    if (!waypoint_c->has_elevation) waypoint_c->elevation = 0.0;
+    waypoint_c->has_heading = (valid & WP_HEADING) != 0;
+    if (!waypoint_c->has_heading) waypoint_c->heading = 0.0;
+    return true;
+}
+
+// {"WayPoint": {...}} 컨테이너 하나
+static bool parse_waypoint_container(StreamCursor* c, SdsJson_WayPoint_t* waypoint_c) {
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    bool found = false;
+    int r;
+
+    if (!enter_container(c, '{')) return false;
+    while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+        if (!found && strcmp(key, "WayPoint") == 0) {
+            found = true;
+            if (!peek_char(c, '{') || !parse_waypoint(c, waypoint_c)) return false;
+        } else if (!skip_value(c)) {
+            return false;
+        }
+    }
+    return r == 0 && found;
+}
+
+// 지연 디코딩: 각 WayPoint 컨테이너의 시작 위치만 기록하고 첫/마지막 원소만 디코딩
+static bool index_waypoint_list(StreamCursor* c, SdsJson_TrafficObject_t* traffic_obj_c) {
+    bool first = true;
+    int capacity = 0;
+    int r;
+
+    if (!enter_container(c, '[')) return false;
+    while ((r = next_element(c, &first)) == 1) {
+        if (traffic_obj_c->num_way_points == capacity) {
+            unsigned int* grown = (unsigned int*)grow_array(traffic_obj_c->way_point_offsets, &capacity, sizeof(unsigned int));
+            if (!grown) {
+                perror("Failed to allocate memory for WayPoint offsets");
+                return false;
+            }
+            traffic_obj_c->way_point_offsets = grown;
+        }
+        if (!peek_char(c, '{')) return false; // 컨테이너는 객체여야 함
+        traffic_obj_c->way_point_offsets[traffic_obj_c->num_way_points++] = (unsigned int)(c->p - c->base);
+        c->fast_numbers = true;
+        bool ok = skip_value(c);
+        c->fast_numbers = false;
+        if (!ok) return false;
+    }
+    if (r != 0) return false;
+
+    int n = traffic_obj_c->num_way_points;
+    if (n == 0) return true;
+    traffic_obj_c->way_point_list = (SdsJson_WayPoint_t*)sds_mem_calloc((size_t)n, sizeof(SdsJson_WayPoint_t));
+    traffic_obj_c->way_point_decoded = (unsigned char*)sds_mem_calloc((size_t)n, 1);
+    if (!traffic_obj_c->way_point_list || !traffic_obj_c->way_point_decoded) {
+        perror("Failed to allocate memory for WayPointList");
+        return false;
+    }
+    traffic_obj_c->way_point_source = c->base;
+    traffic_obj_c->way_point_source_len = (size_t)(c->end - c->base);
+
+    // 상태 분석에서 항상 읽는 첫/마지막 원소는 바로 디코딩 (잘못된 값이면 즉시 디코딩과 같이 프레임 거부)
+    if (!sds_json_stream_decode_waypoint(traffic_obj_c, 0)) return false;
+    if (n > 1 && !sds_json_stream_decode_waypoint(traffic_obj_c, n - 1)) return false;
+    return true;
+}
+
+static bool parse_waypoint_list(StreamCursor* c, SdsJson_TrafficObject_t* traffic_obj_c) {
+    bool first = true;
+    int capacity = 0;
+    int r;
+
+    if (c->lazy_waypoints) return index_waypoint_list(c, traffic_obj_c);
+    if (!enter_container(c, '[')) return false;
+    while ((r = next_element(c, &first)) == 1) {
+        if (traffic_obj_c->num_way_points == capacity) {
+            SdsJson_WayPoint_t* grown = (SdsJson_WayPoint_t*)grow_array(traffic_obj_c->way_point_list, &capacity, sizeof(SdsJson_WayPoint_t));
+            if (!grown) {
+                perror("Failed to allocate memory for WayPointList");
+                return false;
+            }
+            traffic_obj_c->way_point_list = grown;
+        }
+        if (!parse_waypoint_container(c, &traffic_obj_c->way_point_list[traffic_obj_c->num_way_points])) return false;
+        traffic_obj_c->num_way_points++;
+    }
+    return r == 0;
+}
+
+enum {
+    TO_OBJECT_TYPE = 1u << 0, TO_OBJECT_ID = 1u << 1, TO_IS_SHARED = 1u << 2,
+    TO_INTENT = 1u << 3, TO_WAYPOINT_LIST = 1u << 4
+};
+
+static bool parse_traffic_object(StreamCursor* c, SdsJson_TrafficObject_t* traffic_obj_c) {
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    unsigned seen = 0, valid = 0;
+    double intent = 0.0;
+    int r;
+
+    if (!enter_container(c, '{')) return false;
+    while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+        bool ok;
+        if (strcmp(key, "ObjectType") == 0) {
+            ok = read_string_member(c, &seen, &valid, TO_OBJECT_TYPE, traffic_obj_c->object_type, sizeof(traffic_obj_c->object_type));
+        } else if (strcmp(key, "ObjectID") == 0) {
+            ok = read_string_member(c, &seen, &valid, TO_OBJECT_ID, traffic_obj_c->object_id, sizeof(traffic_obj_c->object_id));
+        } else if (strcmp(key, "IsDrivingIntentShared") == 0) {
+            ok = read_bool_member(c, &seen, &valid, TO_IS_SHARED, &traffic_obj_c->is_driving_intent_shared);
+        } else if (strcmp(key, "IGIntersectionIntent") == 0) {
+            ok = read_number_member(c, &seen, &valid, TO_INTENT, &intent);
+        } else if (strcmp(key, "WayPointList") == 0 && !(seen & TO_WAYPOINT_LIST) && peek_char(c, '[')) {
+            seen |= TO_WAYPOINT_LIST;
+            ok = parse_waypoint_list(c, traffic_obj_c);
+            if (ok) valid |= TO_WAYPOINT_LIST;
+        } else {
+            if (strcmp(key, "WayPointList") == 0) seen |= TO_WAYPOINT_LIST;
+            ok = skip_value(c);
+        }
+        if (!ok) return false;
+    }
+    if (r < 0) return false;
+
+    unsigned mandatory = TO_OBJECT_TYPE | TO_OBJECT_ID | TO_IS_SHARED | TO_INTENT | TO_WAYPOINT_LIST;
+    if ((valid & mandatory) != mandatory) {
+        fprintf(stderr, "Error: TrafficObject mandatory fields missing or wrong type.\n");
+        return false;
+    }
+    traffic_obj_c->ig_intersection_intent = number_to_int(intent);
+    return true;
+}
+
+enum { CP_LAT = 1u << 0, CP_LON = 1u << 1, CP_ELEVATION = 1u << 2 };
+
+static bool parse_conflict_position(StreamCursor* c, SdsJson_ConflictPosition_t* conflict_pos_c) {
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    unsigned seen = 0, valid = 0;
+    int r;
+
+    if (!enter_container(c, '{')) return false;
+    while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+        bool ok;
+        if (strcmp(key, "lat") == 0)            ok = read_number_member(c, &seen, &valid, CP_LAT, &conflict_pos_c->lat);
+        else if (strcmp(key, "lon") == 0)       ok = read_number_member(c, &seen, &valid, CP_LON, &conflict_pos_c->lon);
+        else if (strcmp(key, "elevation") == 0) ok = read_number_member(c, &seen, &valid, CP_ELEVATION, &conflict_pos_c->elevation);
+        else                                    ok = skip_value(c);
+        if (!ok) return false;
+    }
+    if (r < 0) return false;
+
+    if ((valid & (CP_LAT | CP_LON)) != (CP_LAT | CP_LON)) {
+        fprintf(stderr, "Error: ConflictPosition mandatory fields (lat, lon) missing or wrong type.\n");
+        return false;
+    }
+    conflict_pos_c->has_elevation = (valid & CP_ELEVATION) != 0;
+    if (!conflict_pos_c->has_elevation) conflict_pos_c->elevation = 0.0;
+    return true;
+}
+
+enum {
+    ATI_CVIB_DIR_CODE = 1u << 0, ATI_CONFLICT_POS = 1u << 1, ATI_PET = 1u << 2,
+    ATI_PET_THRESHOLD = 1u << 3, ATI_HOST_OBJECT = 1u << 4, ATI_REMOTE_OBJECT = 1u << 5
+};
+
+// 선택적 객체 필드 (ConflictPos, RemoteObject): 첫 번째 값이 객체일 때만 할당해서 파싱
+#define OPTIONAL_OBJECT_MEMBER(bit, field, type, parse_fn, what)                          \
+    do {                                                                                \
+        if ((seen & (bit)) || !peek_char(c, '{')) {                                     \
+            seen |= (bit);                                                              \
+            ok = skip_value(c);                                                         \
+            break;                                                                      \
+        }                                                                               \
+        seen |= (bit);                                                                  \
+        ati_data_c->field = (type*)sds_mem_calloc(1, sizeof(type));                     \
+        if (!ati_data_c->field) {                                                       \
+            perror("Failed to allocate memory for " what);                              \
+            return false;                                                               \
+        }                                                                               \
+        ok = parse_fn(c, ati_data_c->field);                                            \
+    } while (0)
+
+static bool parse_approach_traffic_info_data(StreamCursor* c, SdsJson_ApproachTrafficInfoData_t* ati_data_c) {
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    unsigned seen = 0, valid = 0;
+    double cvib_dir_code = 0.0;
+    int r;
+
+    if (!enter_container(c, '{')) return false;
+    while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+        bool ok;
+        if (strcmp(key, "CVIBDirCode") == 0) {
+            ok = read_number_member(c, &seen, &valid, ATI_CVIB_DIR_CODE, &cvib_dir_code);
+        } else if (strcmp(key, "ConflictPos") == 0) {
+            OPTIONAL_OBJECT_MEMBER(ATI_CONFLICT_POS, conflict_pos, SdsJson_ConflictPosition_t, parse_conflict_position, "ConflictPosition");
+        } else if (strcmp(key, "PET") == 0) {
+            ok = read_number_member(c, &seen, &valid, ATI_PET, &ati_data_c->pet);
+        } else if (strcmp(key, "PET_Threshold") == 0) {
+            ok = read_number_member(c, &seen, &valid, ATI_PET_THRESHOLD, &ati_data_c->pet_threshold);
+        } else if (strcmp(key, "HostObject") == 0 && !(seen & ATI_HOST_OBJECT) && peek_char(c, '{')) {
+            seen |= ATI_HOST_OBJECT;
+            ok = parse_traffic_object(c, &ati_data_c->host_object);
+            if (ok) valid |= ATI_HOST_OBJECT;
+        } else if (strcmp(key, "RemoteObject") == 0) {
+            OPTIONAL_OBJECT_MEMBER(ATI_REMOTE_OBJECT, remote_object, SdsJson_TrafficObject_t, parse_traffic_object, "RemoteObject");
+        } else {
+            if (strcmp(key, "HostObject") == 0) seen |= ATI_HOST_OBJECT;
+            ok = skip_value(c);
+        }
+        if (!ok) return false;
+    }
+    if (r < 0) return false;
+
+    if (!(valid & ATI_CVIB_DIR_CODE) || !(valid & ATI_PET_THRESHOLD) || !(valid & ATI_HOST_OBJECT)) {
+        fprintf(stderr, "Error: ApproachTrafficInfoData mandatory fields missing or wrong type.\n");
+        return false;
+    }
+    ati_data_c->cvib_dir_code = number_to_int(cvib_dir_code);
+    ati_data_c->has_pet = (valid & ATI_PET) != 0;
+    if (!ati_data_c->has_pet) ati_data_c->pet = 0.0;
+    return true;
+}
+
+// {"ApproachTrafficInfo": {...}} 컨테이너 하나
+static bool parse_approach_traffic_info_container(StreamCursor* c, SdsJson_ApproachTrafficInfoData_t* ati_data_c) {
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    bool found = false;
+    int r;
+
+    if (!enter_container(c, '{')) return false;
+    while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+        if (!found && strcmp(key, "ApproachTrafficInfo") == 0) {
+            found = true;
+            if (!peek_char(c, '{') || !parse_approach_traffic_info_data(c, ati_data_c)) return false;
+        } else if (!skip_value(c)) {
+            return false;
+        }
+    }
+    return r == 0 && found;
+}
+
+static bool parse_approach_traffic_info_list(StreamCursor* c, SdsJson_MainMessage_t* msg_data) {
+    bool first = true;
+    int capacity = 0;
+    int r;
+
+    if (!enter_container(c, '[')) return false;
+    while ((r = next_element(c, &first)) == 1) {
+        if (msg_data->num_approach_traffic_info == capacity) {
+            SdsJson_ApproachTrafficInfoData_t* grown = (SdsJson_ApproachTrafficInfoData_t*)grow_array(
+                msg_data->approach_traffic_info_list, &capacity, sizeof(SdsJson_ApproachTrafficInfoData_t));
+            if (!grown) {
+                perror("Failed to allocate memory for ApproachTrafficInfoList");
+                return false;
+            }
+            msg_data->approach_traffic_info_list = grown;
+        }
+        // 실패해도 이미 할당된 하위 자원을 free_sds_json_main_message가 해제할 수 있도록 먼저 개수에 포함
+        SdsJson_ApproachTrafficInfoData_t* ati = &msg_data->approach_traffic_info_list[msg_data->num_approach_traffic_info++];
+        if (!parse_approach_traffic_info_container(c, ati)) {
+            fprintf(stderr, "Error parsing one of the ApproachTrafficInfo objects.\n");
+            return false;
+        }
+    }
+    return r == 0;
+}
+
+enum { MSG_MSG_COUNT = 1u << 0, MSG_TIMESTAMP = 1u << 1, MSG_ATI_LIST = 1u << 2 };
+
+// --- 공개 함수 구현 ---
+
+bool sds_json_stream_decode_waypoint(SdsJson_TrafficObject_t* traffic_obj_c, int index) {
+    if (!traffic_obj_c->way_point_source || index < 0 || index >= traffic_obj_c->num_way_points) return false;
+
+    const char* base = traffic_obj_c->way_point_source;
+    StreamCursor cursor = { base + traffic_obj_c->way_point_offsets[index], base + traffic_obj_c->way_point_source_len, 0, base, false, false };
+    SdsJson_WayPoint_t decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    if (!parse_waypoint_container(&cursor, &decoded)) return false;
+
+    traffic_obj_c->way_point_list[index] = decoded;
+    traffic_obj_c->way_point_decoded[index] = 1;
+    return true;
+}
+
+SdsJson_MainMessage_t* sds_json_stream_parse_message(const char* json_string, size_t json_len, bool lazy_waypoints) {
+    if (!json_string) return NULL;
+
+    SdsJson_MainMessage_t* msg_data = (SdsJson_MainMessage_t*)sds_mem_calloc(1, sizeof(SdsJson_MainMessage_t));
+    if (!msg_data) {
+        perror("Failed to allocate memory for SdsJson_MainMessage_t");
+        return NULL;
+    }
+
+    // 지연 디코딩 모드에서는 WayPoint를 나중에 읽을 수 있도록 원문을 메시지가 가진 복사본으로 바꿔서 파싱
+    if (lazy_waypoints) {
+        msg_data->source = (char*)sds_mem_calloc(json_len + 1, 1);
+        if (!msg_data->source) {
+            perror("Failed to allocate memory for SDSM source copy");
+            free_sds_json_main_message(msg_data);
+            return NULL;
+        }
+        memcpy(msg_data->source, json_string, json_len);
+        json_string = msg_data->source;
+    }
+
+    StreamCursor cursor = { json_string, json_string + json_len, 0, json_string, lazy_waypoints, false };
+    StreamCursor* c = &cursor;
+    if (json_len >= 3 && memcmp(json_string, "\xEF\xBB\xBF", 3) == 0) c->p += 3; // UTF-8 BOM
+
+    char key[STREAM_KEY_MAX];
+    bool first = true;
+    unsigned seen = 0, valid = 0;
+    double msg_count = 0.0;
+    bool parse_ok = true;
+    int r = -1;
+
+    if (!peek_char(c, '{')) {
+        // 최상위가 객체가 아니면 문법 검사만 하고 필수 필드 누락으로 처리 (cJSON 경로와 동일)
+        parse_ok = skip_value(c);
+    } else {
+        enter_container(c, '{');
+        while ((r = next_member(c, &first, key, sizeof(key))) == 1) {
+            bool ok;
+            if (strcmp(key, "MsgCount") == 0) {
+                ok = read_number_member(c, &seen, &valid, MSG_MSG_COUNT, &msg_count);
+            } else if (strcmp(key, "Timestamp") == 0) {
+                ok = read_string_member(c, &seen, &valid, MSG_TIMESTAMP, msg_data->timestamp, sizeof(msg_data->timestamp));
+            } else if (strcmp(key, "ApproachTrafficInfoList") == 0 && !(seen & MSG_ATI_LIST) && peek_char(c, '[')) {
+                seen |= MSG_ATI_LIST;
+                ok = parse_approach_traffic_info_list(c, msg_data);
+                if (!ok) {
+                    free_sds_json_main_message(msg_data);
+                    return NULL; // 하위 파서가 이미 오류를 출력함
+                }
+                valid |= MSG_ATI_LIST;
+            } else {
+                if (strcmp(key, "ApproachTrafficInfoList") == 0) seen |= MSG_ATI_LIST;
+                ok = skip_value(c);
+            }
+            if (!ok) break;
+        }
+        parse_ok = (r == 0);
+    }
+
+    if (!parse_ok) {
+        fprintf(stderr, "Error parsing JSON at offset %zu.\n", (size_t)(c->p - json_string));
+        free_sds_json_main_message(msg_data);
+        return NULL;
+    }
+
+    if (!(valid & MSG_MSG_COUNT)) {
+        fprintf(stderr, "Error: MsgCount missing or not a number.\n");
+        parse_ok = false;
+    }
+    if (!(valid & MSG_TIMESTAMP)) {
+        fprintf(stderr, "Error: Timestamp missing or not a string.\n");
+        parse_ok = false;
+    }
+    if (parse_ok && !(valid & MSG_ATI_LIST)) {
+        fprintf(stderr, "Error: ApproachTrafficInfoList missing or not an array.\n");
+        parse_ok = false;
+    }
+    if (!parse_ok) {
+        free_sds_json_main_message(msg_data);
+        return NULL;
+    }
+
+    msg_data->msg_count = number_to_int(msg_count);
+    return msg_data;
+}
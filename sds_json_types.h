@@ -24,8 +24,13 @@ typedef struct {
     char object_id[64];       // 예시: "Host1", "V2_SigL_Target1"
     bool is_driving_intent_shared;
     int  ig_intersection_intent;
-    SdsJson_WayPoint_t* way_point_list; // WayPoint 객체의 동적 배열
+    SdsJson_WayPoint_t* way_point_list; // WayPoint 객체의 동적 배열 (지연 디코딩 모드에서는 sds_json_get_waypoint로 읽을 것)
     int num_way_points;               // WayPoint 배열의 크기
+    // 지연 디코딩 모드에서만 사용 (즉시 디코딩했으면 모두 NULL)
+    const char* way_point_source;     // 메시지가 가진 원문 복사본
+    size_t way_point_source_len;
+    unsigned int* way_point_offsets;  // 원문에서 각 {"WayPoint": ...} 컨테이너의 시작 위치
+    unsigned char* way_point_decoded; // way_point_list[i]가 디코딩되었으면 1
 } SdsJson_TrafficObject_t;
 
 // ConflictPos 구조체 정의
@@ -47,16 +52,101 @@ typedef struct {
     SdsJson_TrafficObject_t* remote_object;   // RemoteObject는 선택적 객체이므로 포인터로 선언 (NULL 가능)
 } SdsJson_ApproachTrafficInfoData_t;
 
+struct SdsArena;
+
 // 최상위 JSON 객체 구조체 정의
 typedef struct {
     int msg_count;
     char timestamp[30]; // "YYYY-MM-DD HH:MM:SS.SSS"
     SdsJson_ApproachTrafficInfoData_t* approach_traffic_info_list; // ApproachTrafficInfoData 객체의 동적 배열
     int num_approach_traffic_info;                               // ApproachTrafficInfoList 배열의 크기
+    char* source;             // 지연 디코딩 모드에서 WayPoint를 나중에 읽기 위한 원문 복사본
+    struct SdsArena* arena;   // 이 메시지의 모든 메모리를 가진 아레나 (힙에 개별 할당했으면 NULL)
 } SdsJson_MainMessage_t;
 
+// 전체 파싱 없이 읽어낸 메시지 헤더 (최신 프레임 판별용)
+#define SDS_JSON_MSG_COUNT_MODULUS 128 // MsgCount는 0~127을 순환
+
+typedef struct {
+    int msg_count;
+    char timestamp[30]; // Timestamp가 없으면 빈 문자열
+} SdsJson_Header_t;
+
+// sds_json_parse_message가 사용할 파서
+typedef enum {
+    SDS_JSON_PARSER_CJSON = 0,  // cJSON 트리를 만든 뒤 구조체로 복사 (기본값)
+    SDS_JSON_PARSER_STREAM,     // cJSON 없이 한 번에 구조체를 채움 (sds_json_stream.c)
+    SDS_JSON_PARSER_VERIFY      // 두 파서를 모두 실행해 결과를 비교하고 cJSON 결과를 사용
+} SdsJson_ParserKind;
+
 // 함수 프로토타입 선언
 SdsJson_MainMessage_t* sds_json_parse_message(const char* json_string);
 void free_sds_json_main_message(SdsJson_MainMessage_t* msg_data);
 
+/**
+ * @brief 길이가 주어진 JSON 문자열을 현재 선택된 파서로 파싱합니다.
+ */
+SdsJson_MainMessage_t* sds_json_parse_message_len(const char* json_string, size_t json_len);
+
+/**
+ * @brief cJSON을 사용하지 않는 스트리밍 파서. 검증 규칙은 cJSON 경로와 같습니다.
+ * @param lazy_waypoints true면 WayPointList의 위치만 기록하고 첫/마지막 원소만 디코딩합니다.
+ *        이때 중간 원소의 필수 필드 검사는 해당 원소를 읽을 때 합니다.
+ */
+SdsJson_MainMessage_t* sds_json_stream_parse_message(const char* json_string, size_t json_len, bool lazy_waypoints);
+
+/**
+ * @brief 지연 디코딩 모드로 기록된 WayPoint 하나를 원문에서 디코딩해 way_point_list[index]에 채웁니다.
+ */
+bool sds_json_stream_decode_waypoint(SdsJson_TrafficObject_t* traffic_obj_c, int index);
+
+/**
+ * @brief index번째 WayPoint를 반환합니다. 지연 디코딩 모드에서 아직 디코딩하지 않았으면 이때 디코딩합니다.
+ * 첫/마지막 원소는 파싱 시 이미 디코딩되어 있어 바로 반환됩니다.
+ * @return 범위를 벗어났거나 디코딩에 실패하면 NULL.
+ */
+const SdsJson_WayPoint_t* sds_json_get_waypoint(const SdsJson_TrafficObject_t* traffic_obj, int index);
+
+/**
+ * @brief 스트리밍 파서(stream, verify)가 WayPoint를 지연 디코딩할지 설정합니다. cJSON 경로는 항상 즉시 디코딩합니다.
+ */
+void sds_json_set_lazy_waypoints(bool enable);
+
+/**
+ * @brief sds_json_parse_message가 사용할 파서를 선택합니다. (프레임 처리 시작 전에 호출)
+ */
+void sds_json_set_parser(SdsJson_ParserKind kind);
+
+/**
+ * @brief 파싱에 프레임 단위 아레나를 사용할지 설정합니다. (프레임 처리 시작 전, 종료 후에 호출)
+ * 켜면 메시지와 하위 배열, cJSON 트리 노드가 모두 풀에서 꺼낸 아레나 하나에 할당되고,
+ * free_sds_json_main_message는 아레나를 비워 풀에 반납하기만 합니다.
+ * 끌 때는 아레나를 가진 메시지가 모두 해제된 뒤여야 합니다.
+ */
+void sds_json_use_arena(bool enable);
+
+/**
+ * @brief "cjson", "stream", "verify" 문자열을 파서 종류로 변환합니다. 알 수 없으면 SDS_JSON_PARSER_CJSON.
+ */
+SdsJson_ParserKind sds_json_parser_from_string(const char* str);
+
+/**
+ * @brief 두 메시지의 모든 필드가 같은지 비교합니다. 다르면 첫 번째 차이를 diff에 기록합니다.
+ */
+bool sds_json_messages_equal(const SdsJson_MainMessage_t* a, const SdsJson_MainMessage_t* b, char* diff, size_t diff_size);
+
+/**
+ * @brief cJSON 트리를 만들지 않고 최상위 MsgCount와 Timestamp만 읽습니다.
+ * 두 키를 찾으면 나머지 본문은 읽지 않습니다.
+ * @return MsgCount를 읽었으면 true.
+ */
+bool sds_json_peek_header(const char* json_string, size_t json_len, SdsJson_Header_t* out_header);
+
+/**
+ * @brief 두 헤더의 선후를 비교합니다.
+ * Timestamp의 초 단위가 다르면 Timestamp 순서를, 같으면 순환을 고려한 MsgCount 순서를 따릅니다.
+ * @return a가 더 새로우면 양수, 같은 메시지면 0, 더 오래되었으면 음수.
+ */
+int sds_json_header_compare(const SdsJson_Header_t* a, const SdsJson_Header_t* b);
+
 #endif // SDS_JSON_TYPES_H
@@ -0,0 +1,98 @@
+// timer_wheel.c
+
+#include "timer_wheel.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// 만료 시각을 tick으로 올림 (그 tick을 처리할 때는 항상 now >= expires_ms)
+static long long tick_of(const TimerWheel* wheel, long long expires_ms) {
+    if (expires_ms <= 0) return 0;
+    return (expires_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+}
+
+static void unlink_node(TimerWheel* wheel, TimerWheelNode* node) {
+    *node->pprev = node->next;
+    if (node->next) node->next->pprev = node->pprev;
+    node->next = NULL;
+    node->pprev = NULL;
+    wheel->armed--;
+}
+
+bool timer_wheel_init(TimerWheel* wheel, size_t num_slots, int tick_ms, long long now_ms) {
+    wheel->slots = (TimerWheelNode**)calloc(num_slots, sizeof(TimerWheelNode*));
+    if (!wheel->slots) {
+        perror("Failed to allocate TimerWheel slots");
+        return false;
+    }
+    wheel->num_slots = num_slots;
+    wheel->tick_ms = (tick_ms > 0) ? tick_ms : 1;
+    wheel->next_tick = now_ms / wheel->tick_ms;
+    wheel->armed = 0;
+    return true;
+}
+
+void timer_wheel_destroy(TimerWheel* wheel) {
+    if (!wheel->slots) return;
+    for (size_t i = 0; i < wheel->num_slots; ++i) {
+        while (wheel->slots[i]) unlink_node(wheel, wheel->slots[i]);
+    }
+    free(wheel->slots);
+    wheel->slots = NULL;
+}
+
+void timer_wheel_schedule(TimerWheel* wheel, TimerWheelNode* node, long long expires_ms) {
+    if (node->pprev) unlink_node(wheel, node);
+
+    long long tick = tick_of(wheel, expires_ms);
+    if (tick < wheel->next_tick) tick = wheel->next_tick;
+    TimerWheelNode** head = &wheel->slots[tick % (long long)wheel->num_slots];
+
+    node->expires_ms = expires_ms;
+    node->next = *head;
+    node->pprev = head;
+    if (*head) (*head)->pprev = &node->next;
+    *head = node;
+    wheel->armed++;
+}
+
+void timer_wheel_cancel(TimerWheel* wheel, TimerWheelNode* node) {
+    if (node->pprev) unlink_node(wheel, node);
+}
+
+size_t timer_wheel_advance(TimerWheel* wheel, long long now_ms, TimerWheelCallback callback, void* user_data) {
+    long long now_tick = now_ms / wheel->tick_ms;
+    size_t expired = 0;
+    size_t visited = 0;
+
+    // 오래 깨어나지 않았어도 한 바퀴만 돌면 now_ms까지 만료된 타이머를 모두 찾는다
+    while (wheel->next_tick <= now_tick && visited < wheel->num_slots) {
+        TimerWheelNode* node = wheel->slots[wheel->next_tick % (long long)wheel->num_slots];
+        wheel->next_tick++;
+        visited++;
+        while (node) {
+            TimerWheelNode* next = node->next; // 콜백이 노드를 다시 걸어도 (슬롯 맨 앞에 들어감) 순회에 영향 없음
+            if (node->expires_ms <= now_ms) {
+                unlink_node(wheel, node);
+                expired++;
+                callback(node, user_data);
+            }
+            node = next;
+        }
+    }
+    if (wheel->next_tick <= now_tick) wheel->next_tick = now_tick + 1;
+    return expired;
+}
+
+int timer_wheel_next_timeout_ms(const TimerWheel* wheel, long long now_ms, int max_ms) {
+    if (wheel->armed == 0) return max_ms;
+
+    long long max_tick = (now_ms + max_ms) / wheel->tick_ms;
+    long long limit = wheel->next_tick + (long long)wheel->num_slots;
+    for (long long tick = wheel->next_tick; tick <= max_tick && tick < limit; ++tick) {
+        if (wheel->slots[tick % (long long)wheel->num_slots]) {
+            long long wait = tick * wheel->tick_ms - now_ms;
+            return (wait > 0) ? (int)wait : 0;
+        }
+    }
+    return max_ms;
+}
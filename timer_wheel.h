@@ -0,0 +1,71 @@
+// timer_wheel.h
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// 타이머 노드. 타이머를 거는 구조체에 포함시키고 콜백에서 offsetof로 원래 구조체를 찾는다.
+typedef struct TimerWheelNode {
+    struct TimerWheelNode* next;
+    struct TimerWheelNode** pprev;  // 슬롯에 걸려 있지 않으면 NULL
+    long long expires_ms;           // 만료 시각 (호출자가 쓰는 단조 시계 기준 ms)
+} TimerWheelNode;
+
+// 만료된 타이머 콜백. 노드는 이미 휠에서 빠진 상태라 콜백 안에서 다시 걸 수 있다.
+// (콜백 안에서는 넘겨받은 노드만 다시 걸거나 빼야 한다)
+typedef void (*TimerWheelCallback)(TimerWheelNode* node, void* user_data);
+
+// 해시 타이머 휠 (단일 스레드용)
+// 만료 시각을 tick 단위로 올림해 (tick % num_slots) 슬롯에 건다. 한 바퀴보다 먼 타이머는
+// 같은 슬롯에 걸린 채 남아 있다가 만료 시각이 지난 바퀴에서 처리된다.
+typedef struct {
+    TimerWheelNode** slots;
+    size_t num_slots;
+    int tick_ms;
+    long long next_tick;   // 다음에 처리할 tick
+    size_t armed;          // 걸려 있는 타이머 수
+} TimerWheel;
+
+/**
+ * @brief 타이머 휠을 초기화합니다.
+ * @param num_slots 슬롯 수 (한 바퀴 = num_slots * tick_ms).
+ * @param tick_ms 타이머 해상도 (ms).
+ * @param now_ms 현재 시각.
+ * @return 성공 시 true.
+ */
+bool timer_wheel_init(TimerWheel* wheel, size_t num_slots, int tick_ms, long long now_ms);
+
+/**
+ * @brief 타이머 휠을 해제합니다. 걸려 있던 노드는 모두 해제된 상태(NULL 연결)가 됩니다.
+ */
+void timer_wheel_destroy(TimerWheel* wheel);
+
+/**
+ * @brief 노드를 expires_ms에 만료되도록 겁니다. 이미 걸려 있으면 다시 겁니다. 과거 시각이면 다음 advance에서 만료됩니다.
+ */
+void timer_wheel_schedule(TimerWheel* wheel, TimerWheelNode* node, long long expires_ms);
+
+/**
+ * @brief 걸려 있는 노드를 뺍니다. 걸려 있지 않으면 아무 일도 하지 않습니다.
+ */
+void timer_wheel_cancel(TimerWheel* wheel, TimerWheelNode* node);
+
+static inline bool timer_wheel_is_armed(const TimerWheelNode* node) {
+    return node->pprev != NULL;
+}
+
+/**
+ * @brief now_ms까지 지난 tick의 슬롯을 처리하고 만료된 노드마다 콜백을 호출합니다.
+ * @return 만료된 타이머 수.
+ */
+size_t timer_wheel_advance(TimerWheel* wheel, long long now_ms, TimerWheelCallback callback, void* user_data);
+
+/**
+ * @brief 다음으로 타이머가 걸린 슬롯의 tick까지 남은 시간을 반환합니다. (epoll_wait 대기 시간용)
+ * max_ms 안에 걸린 슬롯이 없으면 max_ms를 반환합니다. 먼 바퀴의 타이머 때문에 일찍 깨어날 수는 있습니다.
+ */
+int timer_wheel_next_timeout_ms(const TimerWheel* wheel, long long now_ms, int max_ms);
+
+#endif // TIMER_WHEEL_H